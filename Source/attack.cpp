@@ -17,9 +17,11 @@
 
 
 #include <tuple>
+#include <array>
+#include <algorithm>
 #include <bit>
 
-#if defined(PEXT)
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(_M_X64))
 #include <immintrin.h>
 #endif
 
@@ -207,11 +209,33 @@ template bit64 attack::by_slider<BISHOP>(square, const bit64&);
 template bit64 attack::by_slider<ROOK>(square, const bit64&);
 template bit64 attack::by_slider<QUEEN>(square, const bit64&);
 
+#if defined(PEXT_AVAILABLE)
+
+namespace bmi2
+{
+	static bit64 pext(bit64 occ, bit64 mask)
+	{
+		// extracting the occupancy bits of the mask with the BMI2 instruction PEXT
+		// the instruction is emitted even if BMI2 isn't enabled at build time, it is only executed if the CPU supports it
+
+#if defined(__BMI2__) || defined(_MSC_VER)
+		return _pext_u64(occ, mask);
+#else
+		bit64 index;
+		asm volatile("pextq %2, %1, %0" : "=r"(index) : "r"(occ), "rm"(mask));
+		return index;
+#endif
+	}
+}
+
+#endif
+
 template<piece pc>
 bit64 attack::by_slider(square sq, const bit64& occ)
 {
 	// magic index hashing function to generate sliding moves
-	// if the BMI2 instruction PEXT is enabled, PEXT is used instead for faster performance
+	// if the CPU executes the BMI2 instruction PEXT fast enough, PEXT is used instead for faster performance
+	// the index function doesn't change after startup, so the branch is always predicted correctly
 	
 	if constexpr (pc == QUEEN)
 		return by_slider<ROOK>(sq, occ) | by_slider<BISHOP>(sq, occ);
@@ -220,12 +244,12 @@ bit64 attack::by_slider(square sq, const bit64& occ)
 	verify(pc - 2 == magic::BISHOP || pc - 2 == magic::ROOK);
 	auto& entry{ magic::slider[sq][pc - 2] };
 
-#if defined(PEXT)
-	auto index{ entry.offset + _pext_u64(occ, entry.mask) };
-#else
-	auto index{ entry.offset + ((occ & entry.mask) * entry.magic >> entry.shift) };
+#if defined(PEXT_AVAILABLE)
+	if (magic::mode == magic::lookup::PEXT)
+		return magic::expand(entry, entry.attack_pext[(uint32)bmi2::pext(occ, entry.mask)]);
 #endif
-	return magic::attack_table[(uint32)index];
+	auto index{ (occ & entry.mask) * entry.magic >> entry.shift };
+	return magic::expand(entry, entry.attack[(uint32)index]);
 }
 
 bit64 attack::by_pawns(bit64 pawns, color cl)
@@ -317,6 +341,66 @@ bool attack::see_above(const board& pos, move new_mv, score margin)
 	return mv.cl != cl;
 }
 
+score attack::see(const board& pos, move new_mv)
+{
+	// calculating the exact Static Exchange Evaluation (SEE) of a move with a swap-list
+	// the result agrees with see_above(), i.e. see_above() is true for every margin up to the returned score
+
+	verify(new_mv.sq1() == new_mv.sq2() || pos.pseudolegal(new_mv));
+
+	move::item mv{ new_mv };
+	if (mv.castling())
+		return score(0);
+	if (mv.fl >= PROMO_KNIGHT)
+		mv.pc = mv.promo_pc();
+
+	color cl{ mv.cl ^ 1 };
+	bit64 occ{ (pos.side[BOTH] ^ bit::set(mv.sq1)) | bit::set(mv.sq2) };
+	if (mv.fl == ENPASSANT)
+	{
+		verify(bit::shift(pos.ep_rear, shift::push1x[cl]) & pos.pieces[PAWN] & pos.side[cl]);
+		occ ^= bit::shift(pos.ep_rear, shift::push1x[cl]);
+	}
+	bit64 attackers{ attack::sq(pos, mv.sq2, occ) & ~bit::set(mv.sq1) };
+
+	// collecting the material balance after each capture of the exchange sequence
+
+	std::array<score, 32> gain{};
+	gain[0] = value[mv.vc];
+	piece pc_sq{ mv.pc };
+	int d{};
+
+	while (true)
+	{
+		auto least{ see::least_valuable(pos, attackers & pos.side[cl]) };
+		bit64  att{ std::get<0>(least) };
+		piece   pc{ std::get<1>(least) };
+
+		if (!att)
+			break;
+		attackers ^= att;
+		occ ^= att;
+		attackers |= see::add_x_ray_attacker(pos, mv.sq2, occ);
+
+		// a capture by the king is handled like any other one, as in see_above() its high value
+		// already discourages the king from capturing onto a defended square
+
+		d += 1;
+		verify(d < int(gain.size()));
+		gain[d] = value[pc_sq] - gain[d - 1];
+		pc_sq = pc;
+		cl ^= 1;
+	}
+
+	// minimaxing the balance backwards, because each side can refrain from recapturing
+
+	for ( ; d > 0; --d)
+		gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+
+	verify(see_above(pos, new_mv, gain[0]) && !see_above(pos, new_mv, gain[0] + score(1)));
+	return gain[0];
+}
+
 bool attack::escape(const board& pos, move mv)
 {
 	// checking whether the move escapes a capture
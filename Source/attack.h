@@ -65,5 +65,6 @@ namespace attack
 	// static exchange evaluation
 
 	bool see_above(const board& pos, move new_mv, score margin);
+	score see(const board& pos, move new_mv);
 	bool escape(const board &pos, move new_mv);
 }
\ No newline at end of file
@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <fstream>
 #include <chrono>
+#include <memory>
+#include <array>
 
 #include "main.h"
 #include "types.h"
@@ -31,6 +33,14 @@
 #include "misc.h"
 #include "time.h"
 #include "movegen.h"
+#include "movepick.h"
+#include "history.h"
+#include "eval.h"
+#include "nnue.h"
+#include "bitbase.h"
+#include "magic.h"
+#include "attack.h"
+#include "bit.h"
 #include "board.h"
 #include "bench.h"
 
@@ -213,7 +223,7 @@ void bench::search(const std::string& filename, const milliseconds& time)
 
 		pos.parse_fen(p.fen);
 		threads.clear_history();
-		uci::game_hash[uci::mv_offset] = pos.key.pos;
+		uci::game_hash = { pos.key.pos };
 		uci::hash_table.clear();
 		uci::limit.dt = p.dt;
 		uci::stop = false;
@@ -227,5 +237,405 @@ void bench::search(const std::string& filename, const milliseconds& time)
 		<< "\ntime  : " << interim << " ms"
 		<< "\nnodes : " << search::bench
 		<< "\nnps   : " << search::bench / interim.count() << " kN/s"
+		<< "\npawns : " << threads.get_pawn_hitrate() << " % hits"
+		<< std::endl;
+}
+
+void bench::pick(int iterations)
+{
+	// measuring the throughput of generating, weighting and picking the moves of all positions of the benchmark
+	// the history tables are filled with random scores to weight the quiet moves realistically
+
+	auto hist{ std::make_unique<history>() };
+	rand_64 rand_gen{};
+	auto rand_sc{ [&]() { return int(rand_gen.rand64() % (history::max * 2)) - int(history::max); } };
+
+	for (auto& cl : hist->main)
+		for (auto& sq1 : cl)
+			for (auto& sq2 : sq1)
+				sq2 = rand_sc();
+	for (auto& pc_1 : hist->continuation)
+		for (auto& sq_1 : pc_1)
+			for (auto& pc : sq_1)
+				for (auto& sq : pc)
+					for (auto& entry : sq)
+						entry = rand_sc();
+
+	// the two previous moves are needed to probe the continuation history
+
+	std::array<sstack, 3> stack{};
+	stack[0].mv = move{ G1, F3, KNIGHT, NO_PIECE, WHITE, NO_FLAG };
+	stack[1].mv = move{ G8, F6, KNIGHT, NO_PIECE, BLACK, NO_FLAG };
+
+	std::vector<board> positions(fen::search.size());
+	for (std::size_t i{}; i < positions.size(); ++i)
+		positions[i].parse_fen(fen::search[i].fen);
+
+	std::cout << "running movepick benchmark" << std::endl;
+
+	chronometer chrono{};
+	int64 moves{};
+	for (int i{}; i < iterations; ++i)
+	{
+		for (auto& pos : positions)
+		{
+			movepick<mode::PSEUDOLEGAL> pick(pos, move{}, &stack[2], move{}, *hist);
+			for (move mv{ pick.next() }; mv; mv = pick.next())
+				moves += 1;
+		}
+	}
+
+	auto interim{ std::max(chrono.elapsed(), milliseconds(1)) };
+	std::cout
+		<< "\ntime  : " << interim << " ms"
+		<< "\nmoves : " << moves
+		<< "\nmps   : " << moves / interim.count() << " k/s"
+		<< std::endl;
+}
+
+void bench::eval(int iterations)
+{
+	// measuring the throughput of the static evaluation of all positions of the benchmark and their child positions
+	// the evaluation hash tables are kept across iterations, as they are in the search
+
+	std::vector<board> positions{};
+	for (auto& p : fen::search)
+	{
+		board pos{};
+		pos.parse_fen(p.fen);
+		positions.push_back(pos);
+
+		gen<mode::LEGAL> list(pos);
+		list.gen_all();
+		for (int i{}; i < list.cnt.mv; ++i)
+		{
+			pos.new_move(list.mv[i]);
+			positions.push_back(pos);
+			pos = list.pos;
+		}
+	}
+
+	std::cout << "running evaluation benchmark" << std::endl;
+
+	auto hash{ std::make_unique<eval_hash>(eval_hash::ALLOCATE) };
+	chronometer chrono{};
+	int64 evals{}, sum{};
+	for (int i{}; i < iterations; ++i)
+	{
+		for (auto& pos : positions)
+			sum += eval::static_eval(pos, *hash);
+		evals += positions.size();
+	}
+
+	auto interim{ std::max(chrono.elapsed(), milliseconds(1)) };
+	std::cout
+		<< "\ntime  : " << interim << " ms"
+		<< "\nevals : " << evals
+		<< "\neps   : " << evals / interim.count() << " k/s"
+		<< "\nsum   : " << sum
+		<< std::endl;
+}
+
+void bench::sliders(int iterations)
+{
+	// measuring the throughput of the slider attack lookups with every index function the CPU supports
+	// the sliders of both sides of all benchmark positions are looked up with the occupancies of the evaluation
+	// all index functions have to produce the same attacks
+
+	struct slider
+	{
+		piece pc;
+		square sq;
+		bit64 occ;
+	};
+
+	std::vector<slider> sliders{};
+	for (auto& p : fen::search)
+	{
+		board pos{};
+		pos.parse_fen(p.fen);
+		for (color cl : { WHITE, BLACK })
+		{
+			for (bit64 pc{ pos.pieces[BISHOP] & pos.side[cl] }; pc; pc &= pc - 1)
+				sliders.push_back({ BISHOP, bit::scan(pc), pos.side[BOTH] ^ pos.pieces[QUEEN] });
+			for (bit64 pc{ pos.pieces[ROOK] & pos.side[cl] }; pc; pc &= pc - 1)
+				sliders.push_back({ ROOK, bit::scan(pc), pos.side[BOTH] & ~(pos.pieces[QUEEN] | (pos.pieces[ROOK] & pos.side[cl])) });
+			for (bit64 pc{ pos.pieces[QUEEN] & pos.side[cl] }; pc; pc &= pc - 1)
+				sliders.push_back({ QUEEN, bit::scan(pc), pos.side[BOTH] });
+		}
+	}
+
+	int64 cnt{ int64(sliders.size()) * iterations };
+	std::cout << "running slider attack benchmark" << std::endl;
+	std::cout << "\nsliders : " << cnt;
+
+	// looking up the attacks, restoring the index function selected at startup afterwards
+
+	std::vector<bit64> reference{};
+	bit64 reference_sum{};
+	int mismatches{};
+	magic::lookup selected{ magic::mode };
+	for (magic::lookup lu : { magic::lookup::MAGIC, magic::lookup::PEXT })
+	{
+		if (lu == magic::lookup::PEXT && !cpu::bmi2())
+			continue;
+
+		magic::mode = lu;
+		chronometer chrono{};
+		bit64 sum{};
+		for (int i{}; i < iterations; ++i)
+			for (auto& s : sliders)
+				sum += attack::by_piece(s.pc, s.sq, WHITE, s.occ);
+		auto interim{ std::max(chrono.elapsed(), milliseconds(1)) };
+
+		// checking the equivalence of the attacks against the first index function
+
+		bool first{ reference.empty() };
+		for (std::size_t i{}; i < sliders.size(); ++i)
+		{
+			bit64 att{ attack::by_piece(sliders[i].pc, sliders[i].sq, WHITE, sliders[i].occ) };
+			if (first)
+				reference.push_back(att);
+			else
+				mismatches += att != reference[i];
+		}
+		if (first)
+			reference_sum = sum;
+		mismatches += sum != reference_sum;
+
+		std::string name{ magic::lookup_name[int(lu)] };
+		name.resize(8, ' ');
+		std::cout << "\n" << name << ": " << interim << " ms, " << cnt / interim.count() << " k/s"
+			<< (lu == selected ? " (selected)" : "");
+	}
+	magic::mode = selected;
+
+	std::cout << "\nequal   : " << (mismatches == 0 ? "yes" : "no") << std::endl;
+}
+
+void bench::nnue(int iterations)
+{
+	// measuring the throughput of the neural network evaluation of the child positions of all benchmark positions
+	// the child positions are evaluated once from scratch and once by updating the accumulator of the parent
+	// both ways and all inference kernels have to produce the same evaluation
+	// a network with random weights is used if no network is loaded
+
+	bool random_net{ !nnue::active() };
+	if (random_net)
+		nnue::load_random();
+
+	std::vector<board> positions{};
+	std::vector<std::vector<move>> moves{};
+	for (auto& p : fen::search)
+	{
+		board pos{};
+		pos.parse_fen(p.fen);
+		gen<mode::LEGAL> list(pos);
+		list.gen_all();
+		positions.push_back(pos);
+		moves.emplace_back(list.mv.begin(), list.mv.begin() + list.cnt.mv);
+	}
+
+	std::cout << "running neural network benchmark" << std::endl;
+
+	// evaluating from scratch
+
+	chronometer chrono{};
+	int64 evals{}, sum_refresh{};
+	for (int i{}; i < iterations; ++i)
+	{
+		for (std::size_t j{}; j < positions.size(); ++j)
+		{
+			for (move mv : moves[j])
+			{
+				board pos{ positions[j] };
+				pos.new_move(mv);
+				sum_refresh += nnue::static_eval(pos);
+			}
+			evals += moves[j].size();
+		}
+	}
+	auto interim_refresh{ std::max(chrono.elapsed(), milliseconds(1)) };
+
+	// evaluating through accumulator updates
+
+	std::vector<nnue::accumulator> acc(2);
+	chrono.start();
+	int64 sum_update{};
+	for (int i{}; i < iterations; ++i)
+	{
+		for (std::size_t j{}; j < positions.size(); ++j)
+		{
+			board root{ positions[j] };
+			root.acc = acc.data();
+			nnue::refresh(root, acc[0]);
+			for (move mv : moves[j])
+			{
+				board pos{ root };
+				pos.new_move(mv);
+				sum_update += nnue::static_eval(pos);
+			}
+		}
+	}
+	auto interim_update{ std::max(chrono.elapsed(), milliseconds(1)) };
+
+	// checking the updated accumulators against refreshed accumulators
+
+	int mismatches{};
+	std::vector<nnue::accumulator> children{};
+	std::vector<color> children_cl{};
+	for (std::size_t j{}; j < positions.size(); ++j)
+	{
+		board root{ positions[j] };
+		root.acc = acc.data();
+		nnue::refresh(root, acc[0]);
+		for (move mv : moves[j])
+		{
+			board pos{ root };
+			pos.new_move(mv);
+			nnue::static_eval(pos);
+			nnue::accumulator ref{};
+			nnue::refresh(pos, ref);
+			mismatches += ref.v != acc[1].v;
+			children.push_back(acc[1]);
+			children_cl.push_back(pos.cl);
+		}
+	}
+
+	// running all inference kernels on the same accumulators
+
+	std::cout
+		<< "\nevals   : " << evals
+		<< "\nrefresh : " << interim_refresh << " ms, " << evals / interim_refresh.count() << " k/s"
+		<< "\nupdate  : " << interim_update  << " ms, " << evals / interim_update.count()  << " k/s";
+
+	int64 sum_scalar{};
+	for (auto kn : { nnue::kernel::SCALAR, nnue::kernel::SSE2, nnue::kernel::AVX2 })
+	{
+		if (kn > nnue::best_kernel)
+			break;
+
+		chrono.start();
+		int64 sum_kernel{};
+		for (int i{}; i < iterations; ++i)
+			for (std::size_t j{}; j < children.size(); ++j)
+				sum_kernel += nnue::output(children[j], children_cl[j], kn);
+		auto interim_kernel{ std::max(chrono.elapsed(), milliseconds(1)) };
+
+		if (kn == nnue::kernel::SCALAR)
+			sum_scalar = sum_kernel;
+		mismatches += sum_kernel != sum_scalar;
+
+		std::string name{ nnue::kernel_name[int(kn)] };
+		std::cout << "\n" << name << std::string(8 - name.size(), ' ') << ": "
+			<< interim_kernel << " ms, " << int64(children.size()) * iterations / interim_kernel.count() << " k/s";
+	}
+
+	std::cout
+		<< "\nequal   : " << (mismatches == 0 && sum_refresh == sum_update ? "yes" : "no")
+		<< (random_net ? " (random network)" : "")
+		<< std::endl;
+
+	if (random_net)
+		nnue::unload();
+}
+
+void bench::bitbase(int iterations)
+{
+	// measuring the generation time & the probing throughput of the built-in bitbases
+	// all positions are cross-checked against a one-ply search with the legal move generator of the engine:
+	// a position has to be won exactly if one of its child positions is lost for the opponent
+	// the same position with colors flipped has to give the same result
+
+	std::cout << "running bitbase benchmark" << std::endl;
+
+	std::array<piece, 3> endgame{ { QUEEN, ROOK, PAWN } };
+	std::array<const char*, 3> name{ { "KQvK", "KRvK", "KPvK" } };
+	chronometer chrono{};
+	for (int i{}; i < 3; ++i)
+	{
+		chrono.start();
+		bitbase::generate(endgame[i]);
+		std::cout << "\n" << name[i] << "    : " << chrono.elapsed() << " ms";
+	}
+
+	auto set_up{ [](board& pos, piece pc, color strong, color cl, square sk, square wk, square sq)
+	{
+		int flip{ strong == WHITE ? 0 : 56 };
+		pos.reset();
+		for (auto [p, c, s] : { std::tuple{ KING, strong, sk }, std::tuple{ KING, color(strong ^ 1), wk }, std::tuple{ pc, strong, sq } })
+		{
+			square sq_flip{ square(s ^ flip) };
+			pos.pieces[p] |= bit::set(sq_flip);
+			pos.side[c] |= bit::set(sq_flip);
+			pos.piece_on[sq_flip] = p;
+			if (p == KING)
+				pos.sq_king[c] = sq_flip;
+		}
+		pos.side[BOTH] = pos.side[WHITE] | pos.side[BLACK];
+		pos.cl = cl;
+		pos.cl_x = color(cl ^ 1);
+		pos.get_keys();
+	} };
+
+	auto from_child{ [](const board& pos)
+	{
+		auto res{ bitbase::probe(pos) };
+		return res == bitbase::result::NONE ? bitbase::result::DRAW : bitbase::result(-int(res));
+	} };
+
+	// cross-checking all legal positions
+
+	int64 positions{};
+	int mismatches{};
+	std::vector<board> probes{};
+	for (piece pc : endgame)
+	{
+		for (int idx{}; idx < 2 * 64 * 64 * 64; ++idx)
+		{
+			square sq{ square(idx & 63) }, wk{ square((idx >> 6) & 63) }, sk{ square((idx >> 12) & 63) };
+			if (sk == wk || sk == sq || wk == sq || (pc == PAWN && (sq < 8 || sq >= 56)))
+				continue;
+
+			board pos{};
+			set_up(pos, pc, WHITE, color(idx >> 18), sk, wk, sq);
+			if (!pos.legal())
+				continue;
+
+			gen<mode::LEGAL> list(pos);
+			list.gen_all();
+			auto best{ list.cnt.mv == 0 && !pos.check() ? bitbase::result::DRAW : bitbase::result::LOSS };
+			for (int i{}; i < list.cnt.mv; ++i)
+			{
+				pos.new_move(list.mv[i]);
+				best = std::max(best, from_child(pos));
+				pos = list.pos;
+			}
+
+			board flipped{};
+			set_up(flipped, pc, BLACK, color(idx >> 18 ^ 1), sk, wk, sq);
+			auto res{ bitbase::probe(pos) };
+			mismatches += res != best || bitbase::probe(flipped) != res;
+
+			positions += 1;
+			if (positions % 64 == 0)
+				probes.push_back(pos);
+		}
+	}
+
+	// probing
+
+	chrono.start();
+	int64 sum{};
+	for (int i{}; i < iterations; ++i)
+		for (auto& pos : probes)
+			sum += int(bitbase::probe(pos));
+	auto interim{ std::max(chrono.elapsed(), milliseconds(1)) };
+
+	std::cout
+		<< "\npositions : " << positions
+		<< "\nprobes    : " << int64(probes.size()) * iterations / interim.count() << " k/s"
+		<< "\nsum       : " << sum
+		<< "\nequal     : " << (mismatches == 0 ? "yes" : "no (" + std::to_string(mismatches) + " mismatches)")
 		<< std::endl;
 }
\ No newline at end of file
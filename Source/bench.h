@@ -31,4 +31,9 @@ namespace bench
 	template<mode md>
 	void perft(board pos, depth dt_max);
 	void search(const std::string &filename, const milliseconds &time);
+	void pick(int iterations);
+	void eval(int iterations);
+	void sliders(int iterations);
+	void nnue(int iterations);
+	void bitbase(int iterations);
 }
\ No newline at end of file
@@ -20,37 +20,15 @@
 
 #include <limits>
 #include <array>
+#include <bit>
 
+#include "main.h"
 #include "types.h"
 
 // manipulating bitboards
 
 namespace bit
 {
-	// bitmasks that have to be initialized
-
-	inline std::array<bit64, 8> fl_adjacent{};
-	inline std::array<std::array<bit64,  8>,  2> ep_adjacent{};
-	inline std::array<std::array<bit64, 64>,  2> in_front{};
-	inline std::array<std::array<bit64, 64>,  2> fl_in_front{};
-	inline std::array<std::array<bit64, 64>,  2> fork_in_front{};
-	inline std::array<std::array<bit64, 64>,  2> front_span{};
-	inline std::array<std::array<bit64, 64>, 64> between{};
-	inline std::array<std::array<bit64, 64>, 64> ray{};
-	inline std::array<std::array<bit64, 64>,  6> pc_attack{};
-	inline std::array<std::array<bit64, 64>,  2> pawn_attack{};
-	inline std::array<std::array<bit64, 64>,  2> king_zone{};
-	inline std::array<std::array<bit64, 64>,  2> connected{};
-
-	void init_masks();
-
-	// bit manipulation functions
-
-	bit64 shift(bit64 bb, int shift);
-	bit64 color(bit64 bb);
-	bit64  set(square sq);
-	square scan(bit64 bb);
-
 	// managing little & big endianness
 
 	template<typename uint> uint byteswap(uint bb);
@@ -109,6 +87,38 @@ namespace bit
 			half_west,
             half_west ^ file[FILE_D]
 	} };
+
+	// bit manipulation functions
+
+	constexpr bit64 shift(bit64 bb, int shift)
+	{
+		// shifting a bitboard without the use of conditionals
+
+		return (bb << shift) | (bb >> (64 - shift));
+	}
+
+	constexpr bit64 color(bit64 bb)
+	{
+		// returning all squares of the same color as the given bitboard
+
+		verify(std::popcount(bb) == 1);
+		return (bb & sq_white) ? sq_white : sq_black;
+	}
+
+	constexpr bit64 set(square sq)
+	{
+		// creating a bitboard out of a given square
+
+		verify(type::sq(sq));
+		return 1ULL << sq;
+	}
+
+	constexpr square scan(bit64 bb)
+	{
+		// finding the least significant bit
+
+		return (square)std::countr_zero(bb);
+	}
 }
 
 // defining piece movements and their restrictions for all non-sliding pieces
@@ -155,4 +165,166 @@ namespace shift
 		{ 10, 0xffc0c0c0c0c0c0c0ULL },
 	    { 17, 0xffff808080808080ULL }
 	} };
+}
+
+// bitmasks that are generated at compile time & stored read-only in the binary
+
+namespace bit
+{
+	struct mask_table
+	{
+		std::array<bit64, 8> fl_adjacent;
+		std::array<std::array<bit64,  8>,  2> ep_adjacent;
+		std::array<std::array<bit64, 64>,  2> in_front;
+		std::array<std::array<bit64, 64>,  2> fl_in_front;
+		std::array<std::array<bit64, 64>,  2> fork_in_front;
+		std::array<std::array<bit64, 64>,  2> front_span;
+		std::array<std::array<bit64, 64>, 64> between;
+		std::array<std::array<bit64, 64>, 64> ray;
+		std::array<std::array<bit64, 64>,  6> pc_attack;
+		std::array<std::array<bit64, 64>,  2> pawn_attack;
+		std::array<std::array<bit64, 64>,  2> king_zone;
+		std::array<std::array<bit64, 64>,  2> connected;
+	};
+
+	constexpr mask_table init_masks()
+	{
+		// generating all bitmasks
+
+		mask_table m{};
+		for (int fl{ FILE_H }; fl <= FILE_A; ++fl)
+		{
+			// adjacent file map & adjacent en-passant squares
+
+			m.fl_adjacent[fl] |= fl > FILE_H ? file[fl - 1] : 0ULL;
+			m.fl_adjacent[fl] |= fl < FILE_A ? file[fl + 1] : 0ULL;
+
+			m.ep_adjacent[WHITE][fl] = m.fl_adjacent[fl] & rank[RANK_4];
+			m.ep_adjacent[BLACK][fl] = m.fl_adjacent[fl] & rank[RANK_5];
+		}
+
+		for (square sq{ H1 }; sq <= A8; sq += 1)
+		{
+			bit64 sq_bit{ set(sq) };
+			int fl{ sq & 7 };
+			int rk{ sq >> 3 };
+
+			// in-front, file-in-front & front-span
+
+			m.in_front[WHITE][sq] = ~(sq_bit - 1) & ~rank[rk];
+			m.in_front[BLACK][sq] =  (sq_bit - 1) & ~rank[rk];
+
+			m.fl_in_front[WHITE][sq] = m.in_front[WHITE][sq] & file[fl];
+			m.fl_in_front[BLACK][sq] = m.in_front[BLACK][sq] & file[fl];
+
+			bit64 file_span{ file[fl] | m.fl_adjacent[fl] };
+			m.front_span[WHITE][sq] = file_span & m.in_front[WHITE][sq];
+			m.front_span[BLACK][sq] = file_span & m.in_front[BLACK][sq];
+
+			m.fork_in_front[WHITE][sq] = m.front_span[WHITE][sq] & ~file[fl];
+			m.fork_in_front[BLACK][sq] = m.front_span[BLACK][sq] & ~file[fl];
+
+			// knight attack map
+
+			for (auto& dr : shift::knight_dr)
+				m.pc_attack[KNIGHT][sq] |= sq_bit & dr.boarder ? 0ULL : shift(sq_bit, dr.shift);
+
+			// bishop attack map (using only odd directions)
+
+			for (int dr{ 1 }; dr < 8; dr += 2)
+			{
+				bit64 b_ray{ sq_bit };
+				while (!(b_ray & shift::dr[dr].boarder))
+				{
+					b_ray = shift(b_ray, shift::dr[dr].shift);
+					m.pc_attack[BISHOP][sq] |= b_ray;
+				}
+			}
+
+			// rook attack map (using only even directions)
+
+			for (int dr{}; dr < 8; dr += 2)
+			{
+				bit64 r_ray{ sq_bit };
+				while (!(r_ray & shift::dr[dr].boarder))
+				{
+					r_ray = shift(r_ray, shift::dr[dr].shift);
+					m.pc_attack[ROOK][sq] |= r_ray;
+				}
+			}
+
+			// queen attack map
+
+			m.pc_attack[QUEEN][sq] = m.pc_attack[ROOK][sq] | m.pc_attack[BISHOP][sq];
+
+			// king attack & king zone map
+
+			for (auto& dr : shift::dr)
+				m.pc_attack[KING][sq] |= sq_bit & dr.boarder ? 0ULL : shift(sq_bit, dr.shift);
+
+			for (auto cl : { WHITE, BLACK })
+			{
+				m.king_zone[cl][sq]  = m.pc_attack[KING][sq];
+				m.king_zone[cl][sq] |= shift(m.pc_attack[KING][sq], shift::push1x[cl]);
+				if (sq % 8 == 0)
+					m.king_zone[cl][sq] |= m.pc_attack[KING][sq] << 1;
+				if (sq % 8 == 7)
+					m.king_zone[cl][sq] |= m.pc_attack[KING][sq] >> 1;
+			}
+
+			// maps to define pawn attacks & connected pawns
+
+			m.pawn_attack[WHITE][sq] = m.pc_attack[KING][sq] & m.pc_attack[BISHOP][sq] & m.in_front[WHITE][sq];
+			m.pawn_attack[BLACK][sq] = m.pc_attack[KING][sq] & m.pc_attack[BISHOP][sq] & m.in_front[BLACK][sq];
+
+			m.connected[WHITE][sq] = (m.fl_adjacent[fl] & rank[rk]) | m.pawn_attack[BLACK][sq];
+			m.connected[BLACK][sq] = (m.fl_adjacent[fl] & rank[rk]) | m.pawn_attack[WHITE][sq];
+
+			for (square sq2{ H1 }; sq2 <= A8; sq2 += 1)
+			{
+				// map of bits between two bits
+
+				square sq_max{ sq > sq2 ? sq : sq2 };
+				square sq_min{ sq > sq2 ? sq2 : sq };
+				m.between[sq][sq2] = (sq_max == A8 ? max : (set(sq_max + 1) - 1)) & ~(set(sq_min) - 1);
+
+				// map of ray between two bits
+
+				bit64 sq2_bit{ set(sq2) };
+				bool success{ false };
+				for (auto& dr : shift::dr)
+				{
+					if (success)
+						break;
+					bit64 new_ray{ sq_bit };
+					while (!(new_ray & dr.boarder))
+					{
+						new_ray |= shift(new_ray, dr.shift);
+						if (new_ray & sq2_bit)
+						{
+							success = true;
+							m.ray[sq][sq2] = new_ray;
+							break;
+						}
+					}
+				}
+			}
+		}
+		return m;
+	}
+
+	inline constexpr mask_table masks{ init_masks() };
+
+	inline constexpr auto& fl_adjacent  { masks.fl_adjacent };
+	inline constexpr auto& ep_adjacent  { masks.ep_adjacent };
+	inline constexpr auto& in_front     { masks.in_front };
+	inline constexpr auto& fl_in_front  { masks.fl_in_front };
+	inline constexpr auto& fork_in_front{ masks.fork_in_front };
+	inline constexpr auto& front_span   { masks.front_span };
+	inline constexpr auto& between      { masks.between };
+	inline constexpr auto& ray          { masks.ray };
+	inline constexpr auto& pc_attack    { masks.pc_attack };
+	inline constexpr auto& pawn_attack  { masks.pawn_attack };
+	inline constexpr auto& king_zone    { masks.king_zone };
+	inline constexpr auto& connected    { masks.connected };
 }
\ No newline at end of file
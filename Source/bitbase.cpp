@@ -0,0 +1,262 @@
+/*
+  Monolith Copyright (C) 2017-2026 Jonas Mayr
+
+  Monolith is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Monolith is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Monolith. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <vector>
+#include <array>
+#include <bit>
+#include <thread>
+
+#include "main.h"
+#include "types.h"
+#include "attack.h"
+#include "bit.h"
+#include "board.h"
+#include "bitbase.h"
+
+namespace
+{
+	// all positions are stored with the strong side as white
+	// the index is made up of the side to move (strong side first), both kings & the piece
+
+	constexpr int size{ 2 * 64 * 64 * 64 };
+	std::array<std::array<bit64, size / 64>, 3> table{};
+
+	// all bitbases are generated on a background thread at startup
+
+	std::jthread generator{};
+
+	int table_index(piece pc)
+	{
+		verify(pc == PAWN || pc == ROOK || pc == QUEEN);
+		return pc == PAWN ? 0 : pc == ROOK ? 1 : 2;
+	}
+
+	constexpr int index(int weak_to_move, int sq_king_strong, int sq_king_weak, int sq_pc)
+	{
+		return ((weak_to_move * 64 + sq_king_strong) * 64 + sq_king_weak) * 64 + sq_pc;
+	}
+}
+
+namespace retro
+{
+	// assisting functions for the retrograde analysis
+	// positions get classified iteratively until nothing changes anymore, all remaining positions are drawn
+
+	enum state : uint8 { ILLEGAL, UNKNOWN, DRAWN, WON };
+
+	static bool won(piece pc, int idx)
+	{
+		return table[table_index(pc)][idx >> 6] & (1ULL << (idx & 63));
+	}
+
+	static bool illegal(piece pc, int weak_to_move, square sk, square wk, square sq)
+	{
+		// overlapping pieces, adjacent kings, pawns on the first or last rank & the weak king in check with the strong side to move
+
+		if (sk == wk || sk == sq || wk == sq)
+			return true;
+		if (attack::by_piece(KING, sk, WHITE, 0ULL) & bit::set(wk))
+			return true;
+		if (pc == PAWN && (sq < 8 || sq >= 56))
+			return true;
+		return !weak_to_move && (attack::by_piece(pc, sq, WHITE, bit::set(sk) | bit::set(wk)) & bit::set(wk));
+	}
+
+	static bool major_won(piece pc, int weak_to_move, square sk, square wk, square sq)
+	{
+		// KQvK & KRvK don't need a retrograde analysis, the strong side always wins
+		// unless the weak side to move is stalemated or can capture the undefended piece
+
+		if (!weak_to_move)
+			return true;
+
+		bit64 attacked{ attack::by_piece(KING, sk, WHITE, 0ULL) | attack::by_piece(pc, sq, WHITE, bit::set(sk) | bit::set(sq)) };
+		bit64 to{ attack::by_piece(KING, wk, BLACK, 0ULL) & ~attacked };
+		if (!to)
+			return attacked & bit::set(wk);
+		return !(to & bit::set(sq));
+	}
+
+	static state strong_move(const std::vector<state>& db, piece pc, square sk, square wk, square sq)
+	{
+		// the strong side wins if one move leads to a win
+
+		bool unknown{};
+		bit64 occ{ bit::set(sk) | bit::set(wk) | bit::set(sq) };
+		for (bit64 to{ attack::by_piece(KING, sk, WHITE, 0ULL) & ~attack::by_piece(KING, wk, BLACK, 0ULL) & ~bit::set(sq) }; to; to &= to - 1)
+		{
+			state st{ db[index(1, bit::scan(to), wk, sq)] };
+			if (st == WON) return WON;
+			unknown |= st == UNKNOWN;
+		}
+
+		if (pc == PAWN)
+		{
+			// single & double pawn pushes, promotions lead into KQvK & KRvK
+
+			for (int to{ sq + 8 }; to < 64 && !(occ & bit::set(square(to))); to += 8)
+			{
+				if (to >= 56)
+				{
+					if (won(QUEEN, index(1, sk, wk, to)) || won(ROOK, index(1, sk, wk, to)))
+						return WON;
+					break;
+				}
+				state st{ db[index(1, sk, wk, to)] };
+				if (st == WON) return WON;
+				unknown |= st == UNKNOWN;
+				if (to >= 24)
+					break;
+			}
+		}
+		else
+		{
+			for (bit64 to{ attack::by_piece(pc, sq, WHITE, occ) & ~(bit::set(sk) | bit::set(wk)) }; to; to &= to - 1)
+			{
+				state st{ db[index(1, sk, wk, bit::scan(to))] };
+				if (st == WON) return WON;
+				unknown |= st == UNKNOWN;
+			}
+		}
+		return unknown ? UNKNOWN : DRAWN;
+	}
+
+	static state weak_move(const std::vector<state>& db, piece pc, square sk, square wk, square sq)
+	{
+		// the weak side draws if one move leads to a draw, capturing the piece always draws
+		// having no moves is checkmate or stalemate
+
+		bit64 attacked{ attack::by_piece(KING, sk, WHITE, 0ULL) | attack::by_piece(pc, sq, WHITE, bit::set(sk) | bit::set(sq)) };
+		bit64 to{ attack::by_piece(KING, wk, BLACK, 0ULL) & ~attacked };
+		if (!to)
+			return attacked & bit::set(wk) ? WON : DRAWN;
+
+		if (to & bit::set(sq))
+			return DRAWN;
+
+		bool unknown{};
+		for (; to; to &= to - 1)
+		{
+			state st{ db[index(0, sk, bit::scan(to), sq)] };
+			if (st == DRAWN) return DRAWN;
+			unknown |= st == UNKNOWN;
+		}
+		return unknown ? UNKNOWN : WON;
+	}
+}
+
+void bitbase::init()
+{
+	// starting the generation of all bitbases without delaying the UCI communication
+	// KQvK & KRvK have to exist before KPvK because of promotions
+
+	generator = std::jthread{ [] { for (piece pc : { QUEEN, ROOK, PAWN }) generate(pc); } };
+}
+
+void bitbase::wait()
+{
+	// waiting until the generation has finished, only the UCI thread calls this
+
+	if (generator.joinable())
+		generator.join();
+}
+
+void bitbase::generate(piece pc)
+{
+	// generating the bitbase of one endgame
+
+	auto& bb{ table[table_index(pc)] };
+	bb = {};
+	if (pc != PAWN)
+	{
+		for (int idx{}; idx < size; ++idx)
+		{
+			square sq{ square(idx & 63) }, wk{ square((idx >> 6) & 63) }, sk{ square((idx >> 12) & 63) };
+			if (!retro::illegal(pc, idx >> 18, sk, wk, sq) && retro::major_won(pc, idx >> 18, sk, wk, sq))
+				bb[idx >> 6] |= 1ULL << (idx & 63);
+		}
+		return;
+	}
+
+	// KPvK is generated through retrograde analysis
+	// only the positions that are still unknown are visited again in every iteration
+
+	std::vector<retro::state> db(size, retro::UNKNOWN);
+	std::vector<int> unknown{};
+	for (int idx{}; idx < size; ++idx)
+	{
+		square sq{ square(idx & 63) }, wk{ square((idx >> 6) & 63) }, sk{ square((idx >> 12) & 63) };
+		if (retro::illegal(pc, idx >> 18, sk, wk, sq))
+			db[idx] = retro::ILLEGAL;
+		else
+			unknown.push_back(idx);
+	}
+
+	for (bool changed{ true }; changed; )
+	{
+		changed = false;
+		std::size_t remaining{};
+		for (int idx : unknown)
+		{
+			square sq{ square(idx & 63) }, wk{ square((idx >> 6) & 63) }, sk{ square((idx >> 12) & 63) };
+			retro::state st{ idx >> 18 ? retro::weak_move(db, pc, sk, wk, sq) : retro::strong_move(db, pc, sk, wk, sq) };
+			if (st == retro::UNKNOWN)
+				unknown[remaining++] = idx;
+			else
+			{
+				db[idx] = st;
+				changed = true;
+			}
+		}
+		unknown.resize(remaining);
+	}
+
+	for (int idx{}; idx < size; ++idx)
+		if (db[idx] == retro::WON)
+			bb[idx >> 6] |= 1ULL << (idx & 63);
+}
+
+bool bitbase::win(piece pc, color cl, square sq_king_strong, square sq_king_weak, square sq_pc)
+{
+	// probing with the strong side as white, cl being the side to move
+
+	return retro::won(pc, index(cl, sq_king_strong, sq_king_weak, sq_pc));
+}
+
+bitbase::result bitbase::probe(const board& pos)
+{
+	// probing positions with a lone king against king & pawn, rook or queen
+	// the board is flipped vertically if black is the strong side
+
+	if (std::popcount(pos.side[BOTH]) != 3)
+		return result::NONE;
+
+	bit64 pc_bb{ pos.side[BOTH] & ~pos.pieces[KING] };
+	square sq{ bit::scan(pc_bb) };
+	piece pc{ pos.piece_on[sq] };
+	if (pc != PAWN && pc != ROOK && pc != QUEEN)
+		return result::NONE;
+
+	color strong{ pos.side[WHITE] & pc_bb ? WHITE : BLACK };
+	int flip{ strong == WHITE ? 0 : 56 };
+	bool won{ win(pc, color(pos.cl ^ strong), square(pos.sq_king[strong] ^ flip), square(pos.sq_king[strong ^ 1] ^ flip), square(sq ^ flip)) };
+
+	if (!won)
+		return result::DRAW;
+	return pos.cl == strong ? result::WIN : result::LOSS;
+}
\ No newline at end of file
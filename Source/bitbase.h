@@ -0,0 +1,45 @@
+/*
+  Monolith Copyright (C) 2017-2026 Jonas Mayr
+
+  Monolith is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Monolith is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Monolith. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "board.h"
+#include "types.h"
+
+// built-in bitbases of the endgames KPvK, KRvK & KQvK
+// they are generated at startup and don't need any external files, only KPvK needs a retrograde analysis
+// every position takes one bit, telling whether the side with the piece wins or not
+
+namespace bitbase
+{
+	enum class result { LOSS = -1, DRAW = 0, WIN = 1, NONE = 2 };
+
+	// generating all bitbases on a background thread, they have to be complete before the first probe
+
+	void init();
+	void wait();
+
+	// generating the bitbase of one endgame, KQvK & KRvK have to exist before KPvK because of promotions
+
+	void generate(piece pc);
+
+	// probing the bitbases from the point of view of the side to move
+
+	result probe(const board& pos);
+	bool win(piece pc, color cl, square sq_king_strong, square sq_king_weak, square sq_pc);
+}
\ No newline at end of file
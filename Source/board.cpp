@@ -19,6 +19,8 @@
 #include <sstream>
 #include <cctype>
 #include <string>
+#include <algorithm>
+#include <bit>
 
 #include "main.h"
 #include "types.h"
@@ -26,6 +28,7 @@
 #include "zobrist.h"
 #include "bit.h"
 #include "move.h"
+#include "nnue.h"
 #include "board.h"
 
 void board::parse_fen(const std::string& fen_string)
@@ -137,6 +140,7 @@ void board::get_keys()
 	key.pawn = zobrist::pawn_key(*this);
 	key.minor = zobrist::minor_key(*this);
 	key.major = zobrist::major_key(*this);
+	key.mat = zobrist::mat_key<board>(*this, false);
     key.nonpawn[WHITE] = zobrist::nonpawn_key(*this, WHITE);
     key.nonpawn[BLACK] = zobrist::nonpawn_key(*this, BLACK);
 }
@@ -156,6 +160,7 @@ void board::new_move(move new_mv)
 
 	move_cnt += 1;
 	half_cnt += 1;
+	null_cnt += 1;
 	last_sq   = NO_SQUARE;
 
 	// decompressing the move
@@ -230,8 +235,14 @@ void board::new_move(move new_mv)
 	cl_x ^= 1;
 	key.pos ^= zobrist::key_cl;
 
+	// handing the new piece placement over to the accumulator of the neural network evaluation
+
+	if (acc)
+		nnue::push(*this);
+
     verify(cl == (cl_x ^ 1));
     verify((side[WHITE] | side[BLACK]) == (side[WHITE] ^ side[BLACK]));
+	verify(zobrist::mat_key<board>(*this, false) == key.mat);
 }
 
 square board::castling_rook(color sd, direction dr) const
@@ -387,6 +398,7 @@ void board::remove_piece(move::item& mv, bit64& sq2)
 
 		key.pos  ^= zobrist::key_pc[cl_x][PAWN][sq];
 		key.pawn ^= zobrist::key_pc[cl_x][PAWN][sq];
+		key.mat  ^= zobrist::key_pc[cl_x][PAWN][std::popcount(pieces[PAWN] & side[cl_x])];
 	}
 	else
 	{
@@ -396,6 +408,7 @@ void board::remove_piece(move::item& mv, bit64& sq2)
 		pieces[mv.vc] &= ~sq2;
 		side[cl_x] &= ~sq2;
 		key.pos ^= zobrist::key_pc[cl_x][mv.vc][mv.sq2];
+		key.mat ^= zobrist::key_pc[cl_x][mv.vc][std::popcount(pieces[mv.vc] & side[cl_x])];
 		key.nonpawn[cl_x] ^= zobrist::key_pc[cl_x][mv.vc][mv.sq2];
 
 		if (mv.vc == PAWN)
@@ -425,13 +438,18 @@ void board::promote_pawn(move::item& mv, bit64& sq2)
 	key.pos  ^= zobrist::key_pc[cl][promo_pc][mv.sq2];
 	key.nonpawn[cl] ^= zobrist::key_pc[cl][promo_pc][mv.sq2];
 
+	// the material key is indexed by the piece count instead of the square
+
+	key.mat ^= zobrist::key_pc[cl][PAWN][std::popcount(pieces[PAWN] & side[cl])];
+	key.mat ^= zobrist::key_pc[cl][promo_pc][std::popcount(pieces[promo_pc] & side[cl]) - 1];
+
 	if (promo_pc == KNIGHT || promo_pc == BISHOP)
 		key.minor ^= zobrist::key_pc[cl][promo_pc][mv.sq2];
 	else if (promo_pc == ROOK || promo_pc == QUEEN)
 		key.major ^= zobrist::key_pc[cl][promo_pc][mv.sq2];
 }
 
-void board::null_move(bit64& ep, square& sq)
+void board::null_move(bit64& ep, square& sq, int& cnt)
 {
 	// doing a "null move" by not moving but pretending to have moved, used for null move pruning
 	// special care for en-passant has to be taken
@@ -445,7 +463,9 @@ void board::null_move(bit64& ep, square& sq)
 		ep_rear = 0ULL;
 	}
 
-	sq = last_sq;
+	sq  = last_sq;
+	cnt = null_cnt;
+	null_cnt  = 0;
 	half_cnt += 1;
 	move_cnt += 1;
 	key.pos  ^= zobrist::key_cl;
@@ -455,7 +475,7 @@ void board::null_move(bit64& ep, square& sq)
 	verify(zobrist::pos_key(*this) == key.pos);
 }
 
-void board::revert_null_move(bit64& ep, square& sq)
+void board::revert_null_move(bit64& ep, square& sq, int& cnt)
 {
 	// undoing the "null move"
 
@@ -467,7 +487,8 @@ void board::revert_null_move(bit64& ep, square& sq)
 		ep_rear = ep;
 	}
 
-	last_sq = sq;
+	last_sq  = sq;
+	null_cnt = cnt;
 	half_cnt -= 1;
 	move_cnt -= 1;
 	key.pos  ^= zobrist::key_cl;
@@ -567,10 +588,9 @@ bool board::lone_bishops() const
 	return side[BOTH] == (pieces[KING] | pieces[BISHOP]);
 }
 
-bool board::repetition(const std::array<key64, 256>& hash, int offset) const
+bool board::repetition(const std::vector<key64>& hash, int offset) const
 {
 	// marking every one-fold-repetition as a draw
-	// the hash array has a big safety margin, 100 + lim::dt would be enough
 
 	verify(hash[offset] == key.pos);
 
@@ -582,7 +602,7 @@ bool board::repetition(const std::array<key64, 256>& hash, int offset) const
 	return false;
 }
 
-bool board::draw(std::array<key64, 256>& hash, int offset) const
+bool board::draw(std::vector<key64>& hash, int offset) const
 {
 	// detecting draw-by-50-move-rule & draw-by-repetition
 	// draw-by-insufficient-mating-material is handled by the static evaluation
@@ -592,6 +612,42 @@ bool board::draw(std::array<key64, 256>& hash, int offset) const
 	return repetition(hash, offset) || half_cnt >= 100;
 }
 
+bool board::cycle(const std::vector<key64>& hash, int offset, depth stack_dt) const
+{
+	// detecting whether the side to move can force a repetition with its next move
+	// if the moves of the opponent cancelled each other out, a single reversible move closes the cycle
+	// if the key difference to a previous position is found in the cuckoo tables and the path of the move is free
+	// only positions inside the search tree are considered, and none beyond the last null move
+
+	verify(hash[offset] == key.pos);
+
+	int end{ std::min({ half_cnt, null_cnt, stack_dt - 1 }) };
+	if (end < 3)
+		return false;
+
+	key64 other{ key.pos ^ hash[offset - 1] ^ zobrist::key_cl };
+	for (int i{ 3 }; i <= end; i += 2)
+	{
+		other ^= hash[offset - i + 1] ^ hash[offset - i] ^ zobrist::key_cl;
+		if (other)
+			continue;
+
+		key64 mv_key{ key.pos ^ hash[offset - i] };
+		int idx{ zobrist::cuckoo_h1(mv_key) };
+		if (zobrist::cuckoo_key[idx] != mv_key)
+		{
+			idx = zobrist::cuckoo_h2(mv_key);
+			if (zobrist::cuckoo_key[idx] != mv_key)
+				continue;
+		}
+
+		move mv{ zobrist::cuckoo_mv[idx] };
+		if (!(bit::ray[mv.sq1()][mv.sq2()] & ~(bit::set(mv.sq1()) | bit::set(mv.sq2())) & side[BOTH]))
+			return true;
+	}
+	return false;
+}
+
 bool board::pseudolegal(move m) const
 {
 	// asserting the correct match between the board and a move
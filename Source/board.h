@@ -19,11 +19,14 @@
 #pragma once
 
 #include <array>
+#include <vector>
 #include <string>
 
 #include "move.h"
 #include "types.h"
 
+namespace nnue { struct accumulator; }
+
 // representing the internal chessboard
 
 class board
@@ -41,6 +44,7 @@ public:
 
 	int move_cnt{};
 	int half_cnt{};
+	int null_cnt{};
 	color cl{};
 	color cl_x{};
 	bit64 ep_rear{};
@@ -55,9 +59,14 @@ public:
 		key64 pawn{};
 		key64 minor{};
 		key64 major{};
+		key64 mat{};
 		std::array<key64, 2> nonpawn{};
 	} key{};
 
+	// pointing to the accumulator stack of the neural network evaluation if it is used by the search
+
+	nnue::accumulator* acc{};
+
 	// parsing a string in FEN-format
 
 	void parse_fen(const std::string& fen_string);
@@ -67,8 +76,8 @@ public:
 	// moving on the board
 
 	void new_move(move new_mv);
-	void null_move(bit64& ep, square& sq);
-	void revert_null_move(bit64& ep, square& sq);
+	void null_move(bit64& ep, square& sq, int& cnt);
+	void revert_null_move(bit64& ep, square& sq, int& cnt);
 
 private:
 	square castling_rook(color cl, direction dr) const;
@@ -92,8 +101,9 @@ public:
 	bool lone_knights() const;
 	bool lone_bishops() const;
 
-	bool repetition(const std::array<key64, 256>& hash, int offset) const;
-	bool draw(std::array<key64, 256> &hash, int offset) const;
+	bool repetition(const std::vector<key64>& hash, int offset) const;
+	bool draw(std::vector<key64>& hash, int offset) const;
+	bool cycle(const std::vector<key64>& hash, int offset, depth stack_dt) const;
 
 	// checking for legality
 
@@ -23,9 +23,11 @@
 
 #include "main.h"
 #include "types.h"
+#include "misc.h"
 #include "attack.h"
 #include "bit.h"
 #include "board.h"
+#include "nnue.h"
 #include "eval.h"
 
 namespace
@@ -131,13 +133,13 @@ namespace
 
 namespace eval
 {
-	static void passed_pawns(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att, kingpawn_hash::hash& entry, color cl)
+	template<color cl> static void passed_pawns(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att, eval_hash::pawn_entry& entry)
 	{
 		// evaluating passed pawns (~200 Elo)
-		// this is the only pawn-related evaluation that cannot be stored in the king-pawn hash table
+		// this is the only pawn-related evaluation that cannot be stored in the pawn hash tables
 
-		color  cl_x{ cl ^ 1 };
-		bit64  passed{ entry.passed[cl] };
+		constexpr color cl_x{ cl ^ 1 };
+		bit64 passed{ entry.passed[cl] };
 		while (passed)
 		{
 			square sq{ bit::scan(passed) };
@@ -196,26 +198,35 @@ namespace eval
 		}
 	}
 
-	static void pawns(const board& pos, kingpawn_hash::hash& entry)
+	static void king_shelter(const board& pos, eval_hash::shelter_entry& entry)
 	{
-		// evaluating everything pawn-related that can be stored in the king-pawn hash table
+		// evaluating the pawns around the kings, which only depends on the pawn structure and the king files
 
 		for (color cl : {WHITE, BLACK})
 		{
-			color cl_x{ cl ^ 1 };
-			file  fl_king{ type::fl_of(pos.sq_king[cl]) };
-			entry.attack[cl_x] = attack::by_pawns(pos.pieces[PAWN] & pos.side[cl_x], cl_x);
-			bit64 pawns{ pos.pieces[PAWN] & pos.side[cl] };
-			bit64 pawns_cl{ pawns };
+			file fl_king{ type::fl_of(pos.sq_king[cl]) };
 
 			// pawn shield evaluation (~35 Elo)
 
-			pawn_shield(entry.score[cl], pawns, cl, fl_king);
+			pawn_shield(entry.score[cl], pos.pieces[PAWN] & pos.side[cl], cl, fl_king);
 
 			// penalty for the king on a flank without pawns (~20 Elo)
 
 			if (!(pos.pieces[PAWN] & bit::flank[fl_king]))
 				entry.score[cl] += king_without_pawns;
+		}
+	}
+
+	static void pawns(const board& pos, eval_hash::pawn_entry& entry)
+	{
+		// evaluating everything pawn-related that can be stored in the pawn-structure hash table
+
+		for (color cl : {WHITE, BLACK})
+		{
+			color cl_x{ cl ^ 1 };
+			entry.attack[cl_x] = attack::by_pawns(pos.pieces[PAWN] & pos.side[cl_x], cl_x);
+			bit64 pawns{ pos.pieces[PAWN] & pos.side[cl] };
+			bit64 pawns_cl{ pawns };
 
 			while (pawns)
 			{
@@ -249,11 +260,11 @@ namespace eval
 		}
 	}
 
-	static void tactics(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att, color cl)
+	template<color cl> static void tactics(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att)
 	{
 		// penalizing tactical threats
 
-		color cl_x{ cl ^ 1 };
+		constexpr color cl_x{ cl ^ 1 };
 		bit64 minors{ pos.pieces[KNIGHT] | pos.pieces[BISHOP] };
 		bit64 minor_attacks{ att[cl_x].pc[KNIGHT] | att[cl_x].pc[BISHOP] };
 		int threat{};
@@ -294,11 +305,11 @@ namespace eval
 		sum[cl] += threat * threat_queen_by_rook;
 	}
 
-	static void king_safety(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att, color cl)
+	template<color cl> static void king_safety(const board& pos, std::array<int, 2>& sum, const std::array<attacks, 2>& att)
 	{
 		// evaluating king safety threats
 
-		color cl_x{ cl ^ 1 };
+		constexpr color cl_x{ cl ^ 1 };
 		bit64 weak_sq{ att[cl].by_1 & (~att[cl_x].by_1 | att[cl_x].pc[QUEEN] | att[cl_x].pc[KING]) & ~att[cl_x].by_2 };
 		bit64 safe_sq{ (~att[cl_x].by_1 | (weak_sq & att[cl].by_2)) & ~pos.side[cl] };
 
@@ -359,7 +370,7 @@ namespace eval
 		}
 	}
 
-	static int initiative(const board &pos, int sc, const kingpawn_hash::hash& entry)
+	static int initiative(const board &pos, int sc, const eval_hash::pawn_entry& entry, const eval_hash::material_entry& mat)
 	{
 		// evaluating the initiative of the side that has the advantage (~5 Elo)
 		// the computed score is applied as a correction
@@ -373,13 +384,13 @@ namespace eval
 		bool pawns_on_both_flanks{ (pos.pieces[PAWN] & bit::half_east) && (pos.pieces[PAWN] & bit::half_west) };
 		bool almost_unwinnable{ outflanking < 0 && !passed_pawns && !pawns_on_both_flanks };
 
+		// the terms that only depend on the material are taken from the material hash table
+
 		int sc_complexity =
-			+ complexity[0] * std::popcount(pos.pieces[PAWN])
+			+ mat.complexity
 			+ complexity[1] * outflanking
 			+ complexity[2] * pawns_on_both_flanks
-			+ complexity[3] * pos.lone_pawns()
-			+ complexity[4] * almost_unwinnable
-			+ complexity[5];
+			+ complexity[4] * almost_unwinnable;
 
 		// if the score is positive, white has the advantage, otherwise black
 		// the score is also not allowed to change sign after the correction
@@ -387,8 +398,8 @@ namespace eval
 		return ((sc_eg > 0) - (sc_eg < 0)) * std::max(S_EG(sc_complexity), -std::abs(sc_eg));
 	}
 
-	static void get_att(piece pc, bit64& pieces, color cl, const board& pos, square& sq, bit64& tar,
-		std::array<attacks, 2>& att, const bit64& mob_area, int& phase)
+	template<color cl> static void get_att(piece pc, bit64& pieces, const board& pos, square& sq, bit64& tar,
+		std::array<attacks, 2>& att, const bit64& mob_area)
 	{
 		// calculating piece attacks
 		
@@ -408,16 +419,15 @@ namespace eval
 		att[cl].pc[pc] |= tar;
 		att[cl].by_2   |= tar & att[cl].by_1;
 		att[cl].by_1   |= tar;
-		phase += phase_value[pc];
-		att[cl^1].pressure.add(pc, tar);
+		att[cl ^ 1].pressure.add(pc, tar);
 	}
 
-	static void pieces(const board& pos, std::array<int, 2>& sum, std::array<attacks, 2>& att, int& phase, color cl)
+	template<color cl> static void pieces(const board& pos, std::array<int, 2>& sum, std::array<attacks, 2>& att)
 	{
 		// evaluating all pieces except pawns
 		// starting by initializing king pressure & finding all pins to restrict piece mobility
 
-		color cl_x{ cl ^ 1 };
+		constexpr color cl_x{ cl ^ 1 };
         bit64 pawns_cl  { pos.pieces[PAWN] & pos.side[cl] };
         bit64 pawns_cl_x{ pos.pieces[PAWN] & pos.side[cl_x] };
 
@@ -432,10 +442,9 @@ namespace eval
         pieces = pos.pieces[KNIGHT] & pos.side[cl];
 		while (pieces)
 		{
-			// evaluating piece position (~15 Elo), mobility (~60 Elo) & piece value
+			// evaluating mobility (~60 Elo)
 
-            get_att(KNIGHT, pieces, cl, pos, sq, targets, att, mob_area, phase);
-			sum[cl] += knight_psq[cl][sq] +piece_value[KNIGHT];
+            get_att<cl>(KNIGHT, pieces, pos, sq, targets, att, mob_area);
             sum[cl] += knight_mobility[std::popcount(targets)];
 
 			// rewarding outposts (~15 Elo)
@@ -460,10 +469,9 @@ namespace eval
         pieces = pos.pieces[BISHOP] & pos.side[cl];
 		while (pieces)
 		{
-			// evaluating piece position (~25 Elo), mobility (~100 Elo) & piece value
+			// evaluating mobility (~100 Elo)
 
-            get_att(BISHOP, pieces, cl, pos, sq, targets, att, mob_area, phase);
-            sum[cl] += bishop_psq[cl][sq] + piece_value[BISHOP];
+            get_att<cl>(BISHOP, pieces, pos, sq, targets, att, mob_area);
             sum[cl] += bishop_mobility[std::popcount(targets)];
 
 			// bishop pair bonus (~40 Elo)
@@ -491,10 +499,9 @@ namespace eval
         pieces = pos.pieces[ROOK] & pos.side[cl];
 		while (pieces)
 		{
-			// evaluating piece position (~10 Elo), mobility (~40 Elo) & piece value
+			// evaluating mobility (~40 Elo)
 
-            get_att(ROOK, pieces, cl, pos, sq, targets, att, mob_area, phase);
-            sum[cl] += rook_psq[cl][sq] + piece_value[ROOK];
+            get_att<cl>(ROOK, pieces, pos, sq, targets, att, mob_area);
             sum[cl] += rook_mobility[std::popcount(targets)];
 
 			// being on a open or semi-open file (~20 Elo)
@@ -522,10 +529,9 @@ namespace eval
         pieces = pos.pieces[QUEEN] & pos.side[cl];
 		while (pieces)
 		{
-			// evaluating piece position (~10 Elo), mobility (~20 Elo) & piece value
+			// evaluating mobility (~20 Elo)
 
-            get_att(QUEEN, pieces, cl, pos, sq, targets, att, mob_area, phase);
-            sum[cl] += queen_psq[cl][sq] + piece_value[QUEEN];
+            get_att<cl>(QUEEN, pieces, pos, sq, targets, att, mob_area);
             sum[cl] += queen_mobility[std::popcount(targets)];
 
 			pieces &= pieces - 1;
@@ -535,57 +541,122 @@ namespace eval
 
         pieces = pos.pieces[KING] & pos.side[cl];
 		{
-			// evaluating piece position (~60 Elo)
+			// generating the king attacks
 
-            get_att(KING, pieces, cl, pos, sq, targets, att, mob_area, phase);
-            sum[cl] += king_psq[cl][sq] + piece_value[KING];
+            get_att<cl>(KING, pieces, pos, sq, targets, att, mob_area);
 		}
 	}
 
-	static int scale_towards_draw(const board& pos, int sc)
+	template<color cl> static void piece_squares(const board& pos, std::array<int, 2>& sum)
+	{
+		// evaluating piece values & piece positions of all pieces except pawns
+		// these terms are cheap and are therefore evaluated before all others to allow a lazy exit
+		// piece positions of knights (~15 Elo), bishops (~25 Elo), rooks (~10 Elo), queens (~10 Elo) & kings (~60 Elo)
+
+		for (bit64 pieces{ pos.pieces[KNIGHT] & pos.side[cl] }; pieces; pieces &= pieces - 1)
+			sum[cl] += knight_psq[cl][bit::scan(pieces)] + piece_value[KNIGHT];
+		for (bit64 pieces{ pos.pieces[BISHOP] & pos.side[cl] }; pieces; pieces &= pieces - 1)
+			sum[cl] += bishop_psq[cl][bit::scan(pieces)] + piece_value[BISHOP];
+		for (bit64 pieces{ pos.pieces[ROOK] & pos.side[cl] }; pieces; pieces &= pieces - 1)
+			sum[cl] += rook_psq[cl][bit::scan(pieces)] + piece_value[ROOK];
+		for (bit64 pieces{ pos.pieces[QUEEN] & pos.side[cl] }; pieces; pieces &= pieces - 1)
+			sum[cl] += queen_psq[cl][bit::scan(pieces)] + piece_value[QUEEN];
+
+		sum[cl] += king_psq[cl][pos.sq_king[cl]] + piece_value[KING];
+	}
+
+	static void material(const board& pos, eval_hash::material_entry& entry)
+	{
+		// evaluating everything that only depends on the material configuration and can be stored in the material hash table
+
+		entry.phase = sum_material(pos, WHITE) + sum_material(pos, BLACK);
+		entry.complexity = complexity[0] * std::popcount(pos.pieces[PAWN]) + complexity[3] * pos.lone_pawns() + complexity[5];
+
+		// the scale factor for few pawns depends on which side is winning
+
+		for (color winning : { WHITE, BLACK })
+		{
+			color loosing{ winning ^ 1 };
+			entry.scale[winning] = 16;
+			if (sum_material(pos, winning) - sum_material(pos, loosing) <= phase_value[KNIGHT])
+				if (int pawns{ std::popcount(pos.side[winning] & pos.pieces[PAWN]) }; pawns <= 2)
+					entry.scale[winning] = int8(scale_few_pawns[pawns]);
+		}
+
+		// flagging material constellations which still have to be tested for the square colors of the bishops
+
+		entry.draw = (pos.lone_bishops() || pos.lone_knights()) && std::popcount(pos.side[BOTH]) <= 4;
+		entry.bishops = (pos.pieces[BISHOP] | pos.pieces[PAWN] | pos.pieces[KING]) == pos.side[BOTH]
+			&& std::popcount(pos.pieces[BISHOP] & pos.side[WHITE]) == 1
+			&& std::popcount(pos.pieces[BISHOP] & pos.side[BLACK]) == 1;
+	}
+
+	static int scale_towards_draw(const board& pos, int sc, const eval_hash::material_entry& mat)
 	{
 		// scaling the score towards a draw if the chances for a win are slight
 
 		verify(!obvious_draw(pos));
 		color winning{ sc < 0 };
-		color loosing{ winning ^ 1 };
 
 		// down-scaling if there aren't many pawns left (~15 Elo)
 
-		if (sum_material(pos, winning) - sum_material(pos, loosing) <= phase_value[KNIGHT])
-			if (int pawns{ std::popcount(pos.side[winning] & pos.pieces[PAWN]) }; pawns <= 2)
-				sc = sc * eval::scale_few_pawns[pawns] / 16;
+		if (mat.scale[winning] != 16)
+			sc = sc * mat.scale[winning] / 16;
 
 		// down-scaling for opposite colored bishops (~15 Elo)
 
-		if ((pos.pieces[BISHOP] | pos.pieces[PAWN] | pos.pieces[KING]) == pos.side[BOTH] && opposite_bishops(pos))
+		if (mat.bishops && opposite_bishops(pos))
 			sc /= 2;
 
 		return sc;
 	}
 
-	static void evaluate(const board& pos, std::array<int, 2>& sum, int& phase, kingpawn_hash::hash& entry)
+	static void evaluate_cheap(const board& pos, std::array<int, 2>& sum, eval_hash& hash,
+		eval_hash::pawn_entry& entry, eval_hash::shelter_entry& shelter)
 	{
 		// beginning with the evaluation of the position
+		// only evaluating the terms that come without generating attacks
 
 		if (pos.pieces[PAWN])
 		{
-			// creating a new table entry if nothing is found in the pawn hash table
-			// the hash table speeds up the engine considerably (~15 Elo)
-			// a table entry provides some basic pawn evaluation
+			// creating new table entries if nothing is found in the pawn hash tables
+			// the hash tables speed up the engine considerably (~15 Elo)
+			// the pawn-structure entry provides some basic pawn evaluation
 
 			verify(pos.key.pawn);
-			if (key64 key{ zobrist::kingpawn_key(pos) }; key != entry.key)
+			hash.cnt_probe += 1;
+			if (entry.key != pos.key.pawn)
 			{
-				entry = kingpawn_hash::hash{};
+				entry = eval_hash::pawn_entry{};
 				pawns(pos, entry);
-				entry.key = key;
+				entry.key = pos.key.pawn;
+				hash.store_pawn(pos, entry);
 			}
+			else
+				hash.cnt_hit += 1;
 
-			sum[WHITE] = entry.score[WHITE];
-			sum[BLACK] = entry.score[BLACK];
+			// the king-shelter entry is kept apart, so that king moves don't invalidate the pawn-structure entry
+
+			if (key64 key{ zobrist::shelter_key(pos) }; key != shelter.key)
+			{
+				shelter = eval_hash::shelter_entry{};
+				king_shelter(pos, shelter);
+				shelter.key = key;
+			}
+
+			sum[WHITE] = entry.score[WHITE] + shelter.score[WHITE];
+			sum[BLACK] = entry.score[BLACK] + shelter.score[BLACK];
 		}
 
+		// evaluating piece values & piece positions
+
+		piece_squares<WHITE>(pos, sum);
+		piece_squares<BLACK>(pos, sum);
+	}
+
+	static void evaluate(const board& pos, std::array<int, 2>& sum, eval_hash::pawn_entry& entry, std::array<bit64, 2>* att_map)
+	{
+		// continuing with the evaluation of all terms that need attack tables
 		// initializing attack tables
 
 		std::array<attacks, 2> att{{ { { pos, WHITE }, { entry.attack[WHITE] }, entry.attack[WHITE], {} },
@@ -593,56 +664,177 @@ namespace eval
 
 		// evaluating pieces
 
-		pieces(pos, sum, att, phase, WHITE);
-		pieces(pos, sum, att, phase, BLACK);
+		pieces<WHITE>(pos, sum, att);
+		pieces<BLACK>(pos, sum, att);
 
 		// evaluating tactical threats against pieces & pawns
 
-		tactics(pos, sum, att, WHITE);
-		tactics(pos, sum, att, BLACK);
+		tactics<WHITE>(pos, sum, att);
+		tactics<BLACK>(pos, sum, att);
 
 		// evaluating king safety threats
 
-		king_safety(pos, sum, att, WHITE);
-		king_safety(pos, sum, att, BLACK);
+		king_safety<WHITE>(pos, sum, att);
+		king_safety<BLACK>(pos, sum, att);
 
 		// extending the pawn evaluation
 
-		passed_pawns(pos, sum, att, entry, WHITE);
-		passed_pawns(pos, sum, att, entry, BLACK);
+		passed_pawns<WHITE>(pos, sum, att, entry);
+		passed_pawns<BLACK>(pos, sum, att, entry);
+
+		// handing the attack tables over to the search
+		// squares attacked by enemy pawns are not part of the mobility area, so they are added to stay a superset
+
+		if (att_map)
+		{
+			(*att_map)[WHITE] = att[WHITE].by_1 | att[BLACK].pc[PAWN];
+			(*att_map)[BLACK] = att[BLACK].by_1 | att[WHITE].pc[PAWN];
+		}
+	}
+
+	static score conclude(const board& pos, const std::array<int, 2>& sum,
+		const eval_hash::pawn_entry& entry, const eval_hash::material_entry& mat)
+	{
+		// adding initiative correction (~5 Elo) before interpolating the scores
+
+		int sc{ sum[WHITE] - sum[BLACK] };
+		sc += initiative(pos, sc, entry, mat);
+		sc  = interpolate(sc, mat.phase);
+		verify(std::abs(sc) < int(LONGEST_MATE));
+
+		// scaling drawn positions (~30 Elo)
+		// also adjusting the sign relative to the side to move and adding a tempo bonus (~5 Elo)
+
+		sc = scale_towards_draw(pos, sc, mat);
+		return score(sc * (pos.cl == WHITE ? 1 : -1) + tempo);
+	}
+
+	static score evaluate_chain(const board& pos, eval_hash& hash, score alpha, score beta, std::array<bit64, 2>* att_map)
+	{
+		// evaluating the position from the cheap to the expensive terms
+		// probing the material hash table first, creating a new table entry if nothing is found
+
+		auto& mat{ hash.get_material(pos) };
+		if (mat.key != pos.key.mat)
+		{
+			mat = eval_hash::material_entry{};
+			material(pos, mat);
+			mat.key = pos.key.mat;
+		}
+
+		// filtering out obviously drawn positions with insufficient mating material
+
+		if (mat.draw && obvious_draw(pos))
+			return DRAW;
+
+		// handing the evaluation over to the neural network if one is loaded
+
+		if (nnue::active())
+			return nnue::static_eval(pos);
+
+		// initializing & probing the pawn hash tables
+
+		std::array<int, 2> sum{};
+		auto& entry{ hash.get_pawn(pos) };
+
+		// evaluating the cheap terms first
+
+		evaluate_cheap(pos, sum, hash, entry, hash.get_shelter(pos));
+
+		// lazy evaluation: skipping all other terms if the score is already outside of the window
+		// the window is widened by the caller, it is unbounded by default
+
+		if (alpha > -MATE || beta < MATE)
+		{
+			if (score sc{ conclude(pos, sum, entry, mat) }; sc <= alpha || sc >= beta)
+				return sc;
+		}
+
+		// evaluating the rest of the position
+
+		evaluate(pos, sum, entry, att_map);
+		return conclude(pos, sum, entry, mat);
 	}
 }
 
-score eval::static_eval(const board& pos, kingpawn_hash& hash)
+score eval::static_eval(const board& pos, eval_hash& hash, score alpha, score beta)
 {
-	// entry point of the evaluation chain
-	// filtering out obviously drawn positions with insufficient mating material first
+	// entry point of the evaluation, with a window that allows a lazy exit
 
-	if (obvious_draw(pos))
-		return DRAW;
+	return evaluate_chain(pos, hash, alpha, beta, nullptr);
+}
+
+score eval::static_eval(const board& pos, eval_hash& hash, std::array<bit64, 2>& att)
+{
+	// entry point of the evaluation, also handing over the attack tables
+	// the attack tables stay empty if the position is an obvious draw or if it is evaluated by the neural network
+
+	att = {};
+	return evaluate_chain(pos, hash, -MATE, MATE, &att);
+}
+
+eval_hash::pawn_entry& eval_hash::get_pawn(const board& pos)
+{
+	// probing the pawn-structure table
+	// entries of the shared table are copied first, because other threads can overwrite them at any time
+
+	if (!pos.pieces[PAWN])
+		return pawn;
+
+	if (use_shared())
+	{
+		shared_copy = shared_table[pos.key.pawn & (shared_table.size() - 1)];
+		shared_copy.key ^= shared_copy.data();
+		return shared_copy;
+	}
+	return pawn_table.empty() ? pawn : pawn_table[pos.key.pawn & (pawn_table.size() - 1)];
+}
 
-	// initializing & probing the pawn hash table
+void eval_hash::prefetch_pawn(key64 pawn_key) const
+{
+	// pre-loading the pawn-structure entry of an upcoming position into cache
 
-	int phase{};
-	std::array<int, 2> sum{};
-	auto& entry{ hash.get_entry(pos) };
+	if (use_shared())
+		memory::prefetch((char*)&shared_table[pawn_key & (shared_table.size() - 1)]);
+	else if (!pawn_table.empty())
+		memory::prefetch((char*)&pawn_table[pawn_key & (pawn_table.size() - 1)]);
+}
 
-	// evaluating the position
+void eval_hash::store_pawn(const board& pos, const pawn_entry& entry)
+{
+	// writing a new entry back into the shared table without locking
+	// entries of the private table have already been updated in place
 
-	evaluate(pos, sum, phase, entry);
+	if (use_shared())
+	{
+		pawn_entry& slot{ shared_table[pos.key.pawn & (shared_table.size() - 1)] };
+		slot = entry;
+		slot.key ^= entry.data();
+	}
+}
 
-	// adding initiative correction (~5 Elo) before interpolating the scores
+std::size_t eval_hash::create(std::size_t kilobytes, bool share)
+{
+	// setting the size of the pawn-structure tables and building the shared table if requested
+	// the tables of the threads have to be allocated again afterwards
 
-	int sc{ sum[WHITE] - sum[BLACK] };
-	sc += initiative(pos, sc, entry);
-	sc  = interpolate(sc, phase);
-	verify(std::abs(sc) < int(LONGEST_MATE));
+	verify(kilobytes <= lim::pawn_hash);
+	std::size_t entries_max{ (kilobytes << 10) / sizeof(pawn_entry) };
 
-	// scaling drawn positions (~30 Elo)
-	// also adjusting the sign relative to the side to move and adding a tempo bonus (~5 Elo)
+	size_pawn = std::bit_floor(std::max(entries_max, std::size_t(1)));
+	shared = share;
+	shared_table = std::vector<pawn_entry>(shared ? size_pawn : 0);
+	return (size_pawn * sizeof(pawn_entry)) >> 10;
+}
+
+void eval_hash::allocate()
+{
+	// allocating the tables of the thread, the pawn-structure table only if it isn't shared
 
-	sc = scale_towards_draw(pos, sc);
-	return score(sc * (pos.cl == WHITE ? 1 : -1) + tempo);
+	pawn_table    = std::vector<pawn_entry>(memory == ALLOCATE_NONE || use_shared() ? 0 : size_pawn);
+	shelter_table = std::vector<shelter_entry>(memory == ALLOCATE_NONE ? 0 : size_shelter);
+	material_table = std::vector<material_entry>(memory == ALLOCATE_NONE ? 0 : size_material);
+	cnt_probe = cnt_hit = 0;
 }
 
 void eval::mirror_tables()
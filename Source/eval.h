@@ -33,12 +33,13 @@ constexpr int S_EG(int sc) { return int(int16(uint16(unsigned(sc)))); }
 
 // evaluating a position
 
-class kingpawn_hash;
+class eval_hash;
 
 namespace eval
 {
 	void  mirror_tables();
-	score static_eval(const board& pos, kingpawn_hash& hash);
+	score static_eval(const board& pos, eval_hash& hash, score alpha = -MATE, score beta = MATE);
+	score static_eval(const board& pos, eval_hash& hash, std::array<bit64, 2>& att);
 
 	// material weights
 
@@ -227,50 +228,108 @@ namespace eval
 	} };
 }
 
-// managing the king-pawn hash table which speeds up the evaluation function
+// managing the hash tables which speed up the evaluation function
+// the pawn structure and the king shelter are stored separately, because only the latter depends on the kings
+// the material table stores everything that only depends on the material configuration
 
-class kingpawn_hash
+class eval_hash
 {
-private:
-	// size of 1 << 11 correlates to a fixed pawn-hash table of ~98 KB per thread
-
-	constexpr static std::size_t size{ 1U << 11 };
-	constexpr static key64 mask{ size - 1 };
-
 public:
 	enum table_memory
 	{
 		ALLOCATE,
+		ALLOCATE_PRIVATE,
 		ALLOCATE_NONE
 	};
 
-	// king-pawn hash entry is 48 bytes
+	// pawn-structure hash entry is 48 bytes
+	// if the table is shared, the key is stored XOR-ed with the data to detect entries written concurrently
 
-	struct hash
+	struct pawn_entry
 	{
 		key64 key{};
 		std::array<bit64, 2> passed{};
 		std::array<bit64, 2> attack{};
 		std::array<int32, 2> score{};
-	} entry;
 
-	static_assert(sizeof(hash) == 48);
+		key64 data() const { return passed[0] ^ passed[1] ^ attack[0] ^ attack[1] ^ (uint64(uint32(score[0])) << 32 | uint32(score[1])); }
+	} pawn;
+
+	static_assert(sizeof(pawn_entry) == 48);
+
+	// king-shelter hash entry is 16 bytes
+
+	struct shelter_entry
+	{
+		key64 key{};
+		std::array<int32, 2> score{};
+	} shelter;
 
-	// actual table
+	static_assert(sizeof(shelter_entry) == 16);
 
-	std::vector<hash> table{};
+	// material hash entry is 24 bytes
 
-	hash& get_entry(const board& pos)
+	struct material_entry
 	{
-		return !table.empty() && pos.pieces[PAWN] ? table[zobrist::kingpawn_key(pos) & mask] : entry;
+		key64 key{};
+		int32 phase{};
+		int32 complexity{};
+		std::array<int8, 2> scale{};
+		bool draw{};
+		bool bishops{};
+	} material;
+
+	static_assert(sizeof(material_entry) == 24);
+
+private:
+	// the size of the pawn-structure table is adjustable, 1 << 11 entries correlate to ~96 KB per thread
+	// the pawn-structure table can also be shared by all threads, so its size is not multiplied by the thread count
+	// size of 1 << 10 correlates to a fixed king-shelter table of ~16 KB per thread
+	// size of 1 << 9 correlates to a fixed material table of ~12 KB per thread
+
+	inline static std::size_t size_pawn{ 1U << 11 };
+	inline static bool shared{};
+	inline static std::vector<pawn_entry> shared_table{};
+
+	constexpr static std::size_t size_shelter{ 1U << 10 };
+	constexpr static key64 mask_shelter{ size_shelter - 1 };
+	constexpr static std::size_t size_material{ 1U << 9 };
+	constexpr static key64 mask_material{ size_material - 1 };
+
+	// actual tables
+
+	table_memory memory{};
+	pawn_entry shared_copy{};
+	std::vector<pawn_entry> pawn_table{};
+	std::vector<shelter_entry> shelter_table{};
+	std::vector<material_entry> material_table{};
+
+	bool use_shared() const { return shared && memory == ALLOCATE; }
+
+public:
+	// keeping track of the pawn-structure table hit-rate
+
+	int64 cnt_probe{};
+	int64 cnt_hit{};
+
+	pawn_entry& get_pawn(const board& pos);
+	void store_pawn(const board& pos, const pawn_entry& entry);
+	void prefetch_pawn(key64 pawn_key) const;
+
+	shelter_entry& get_shelter(const board& pos)
+	{
+		return !shelter_table.empty() && pos.pieces[PAWN] ? shelter_table[zobrist::shelter_key(pos) & mask_shelter] : shelter;
 	}
 
-	kingpawn_hash(table_memory memory)
+	material_entry& get_material(const board& pos)
 	{
-		if (memory == ALLOCATE)
-		{
-			table.resize(size);
-			for (auto& t : table) t = hash{};
-		}
+		return !material_table.empty() ? material_table[pos.key.mat & mask_material] : material;
 	}
+
+	// managing the tables
+
+	static std::size_t create(std::size_t kilobytes, bool share);
+	void allocate();
+
+	eval_hash(table_memory table_mem) : memory{ table_mem } { allocate(); }
 };
\ No newline at end of file
@@ -22,22 +22,25 @@
 #include "main.h"
 #include "types.h"
 #include "move.h"
+#include "misc.h"
 #include "board.h"
 #include "history.h"
 
-void history::update_entry(int& entry, int weight)
+void history::update_entry(int16& entry, int weight)
 {
 	// updating a history entry, the weight is depth dependent, the entry is then gravitated
+	// the update is computed with full precision and only the result is narrowed
 
-	entry += (1 << w.hist_base) * weight - entry * std::abs(weight) / (1 << w.hist_gravity);
-	entry = std::clamp(entry, -(int)max, (int)max);
+	int sc{ entry + (1 << w.hist_base) * weight - entry * std::abs(weight) / (1 << w.hist_gravity) };
+	entry = int16(std::clamp(sc, -(int)max, (int)max));
 }
 
-void history::update_corr(int& entry, int weight)
+void history::update_corr(int16& entry, int weight)
 {
 	// updating a correction history entry, the weight is depth and score dependent
 
-	entry += (1 << w.corr_base) * weight - entry * std::abs(weight) / (1 << w.corr_gravity);
+	int sc{ entry + (1 << w.corr_base) * weight - entry * std::abs(weight) / (1 << w.corr_gravity) };
+	entry = int16(std::clamp(sc, -(int)max, (int)max));
 }
 
 void history::update_quiet(move mv, const sstack* ss, int cnt, int bonus, int malus)
@@ -83,7 +86,7 @@ void history::update_capture(move mv, const sstack* ss, int cnt, int bonus, int
 	}
 }
 
-int history::idx_corr(key64& key)
+int history::idx_corr(const key64& key)
 {
 	// indexing the correction history tables
 
@@ -151,6 +154,25 @@ score history::correct_sc(board& pos, sstack* ss, score sc)
 	return score(std::clamp(sc + correction, TB_LOSS + 1, TB_WIN - 1));
 }
 
+void history::prefetch_corr(const board::key_pos& key, color cl, move mv, const sstack* ss)
+{
+	// pre-loading all correction history entries of the position after move mv into cache
+	// cl is the side to move & ss the search stack of that position
+
+	verify(ss->dt >= 1);
+	piece  pc{ mv.pc()  };
+	square sq{ mv.sq2() };
+
+	memory::prefetch((char*)&corr_pawn[ cl][idx_corr(key.pawn)]);
+	memory::prefetch((char*)&corr_minor[cl][idx_corr(key.minor)]);
+	memory::prefetch((char*)&corr_major[cl][idx_corr(key.major)]);
+	memory::prefetch((char*)&corr_nonpawn[WHITE][cl][idx_corr(key.nonpawn[WHITE])]);
+	memory::prefetch((char*)&corr_nonpawn[BLACK][cl][idx_corr(key.nonpawn[BLACK])]);
+
+	for (int i{ 2 }; i <= std::min(5, int(ss->dt)); ++i)
+		memory::prefetch((char*)&(*(ss - i)->cont_mv)[pc][sq]);
+}
+
 void history::clear()
 {
 	// clearing all tables
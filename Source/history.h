@@ -34,16 +34,18 @@ class history
 private:
 	// updating the history tables
 
-	void update_entry(int& entry, int weight);
-	void update_corr(int& entry, int weight);
+	void update_entry(int16& entry, int weight);
+	void update_corr(int16& entry, int weight);
 	void update_quiet(move mv, const sstack* ss, int cnt, int bonus, int malus);
 	void update_capture(move mv, const sstack* ss, int cnt, int bonus, int malus);
-	int  idx_corr(key64& key);
+	int  idx_corr(const key64& key);
+
+	// all history tables store 16-bit entries to keep the per-thread footprint small
 
 	// history tables to correct the board evaluation through pieces on the board
 
 	static constexpr int corr_size{ 16384 };
-	using corr_table = std::array<std::array<int, corr_size>, 2>;
+	using corr_table = std::array<std::array<int16, corr_size>, 2>;
 
 private:
 	corr_table corr_pawn{};
@@ -54,18 +56,19 @@ private:
 	// history table to correct the board evaluation through continuation sequences
 
 public:
-	std::array<std::array<std::array<std::array<int, 64>, 6>, 65>, 6> corr_cont{};
+	std::array<std::array<std::array<std::array<int16, 64>, 6>, 65>, 6> corr_cont{};
 
 	// history tables to improve move ordering and help pruning and late move reduction during search
 
-	std::array<std::array<std::array<int, 64>, 64>, 2> main{};
-	std::array<std::array<std::array<std::array<int, 6>, 64>, 6>, 2> capture{};
-	std::array<std::array<std::array<std::array<std::array<int, 2>, 64>, 6>, 65>, 6> continuation{};
+	std::array<std::array<std::array<int16, 64>, 64>, 2> main{};
+	std::array<std::array<std::array<std::array<int16, 6>, 64>, 6>, 2> capture{};
+	std::array<std::array<std::array<std::array<std::array<int16, 2>, 64>, 6>, 65>, 6> continuation{};
 
 	// history weights
+	// the gravity keeps entries well within the 16-bit range, the limit only matters for extreme weights
 
-	static const constexpr uint32 max{ 0x20000000 };
-	static_assert(max * 4 == std::numeric_limits<unsigned int>::max() / 2 + 1);
+	static const constexpr uint32 max{ 0x7fff };
+	static_assert(max == std::numeric_limits<int16>::max());
 
 	inline static struct weight
 	{
@@ -84,6 +87,7 @@ public:
 	void  update(move mv, const sstack* ss, int quiet_cnt, int capture_cnt, depth dt);
 	void  update_corr(board& pos, sstack* ss, score best_sc, score eval, depth dt);
 	score correct_sc(board& pos, sstack* ss, score sc);
+	void  prefetch_corr(const board::key_pos& key, color cl, move mv, const sstack* ss);
 	void  clear();
 
 	// probing the history tables during search
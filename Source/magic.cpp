@@ -16,7 +16,8 @@
 */
 
 
-#include <vector>
+#include <utility>
+#include <array>
 #include <bit>
 
 #include "main.h"
@@ -25,196 +26,223 @@
 #include "bit.h"
 #include "magic.h"
 
-#if defined(PEXT)
-#include <immintrin.h>
-#endif
-
 namespace magic
 {
-	// one table is used for both bishops and rooks, ~860 KB
-
-	namespace size
-	{
-		constexpr int bishop{ 5248 };
-		constexpr int rook{ 102400 };
-		constexpr int table{ bishop + rook };
-	}
-
-	static void init_mask(piece pc)
+	// magic numbers of all squares, found through trial & error with sparse random numbers
+	// idea from Tord Romstad:
+	// https://www.chessprogramming.org/Looking_for_Magics
+
+	constexpr std::array<std::array<bit64, 64>, 2> number
+	{ {
+		{ {
+			0x0008200820410020ULL, 0x8208010c0aaa0080ULL, 0x00103c3042402000ULL, 0x0014410020000000ULL,
+			0x0402021009000001ULL, 0x0444222090484000ULL, 0x8000610820900c01ULL, 0x4000421200824000ULL,
+			0x1200100408409408ULL, 0x0204208102220044ULL, 0x010122420c002223ULL, 0x1004042502010000ULL,
+			0x0441441044800080ULL, 0x8000408220200442ULL, 0x00000a0144024000ULL, 0x2000408044022001ULL,
+			0x0020000820040095ULL, 0x0004012818008418ULL, 0x4010000127002100ULL, 0x8032016022810009ULL,
+			0x40030000904002b9ULL, 0x0100810410008800ULL, 0x5138400101286004ULL, 0x1080400221241000ULL,
+			0x0204403422820407ULL, 0x4002a00128810400ULL, 0x0408080101004100ULL, 0x5108080000820500ULL,
+			0x0010030001200800ULL, 0x4208102081100800ULL, 0x1408220842422240ULL, 0x0008404086822802ULL,
+			0x2801286000082001ULL, 0x00a4044501021001ULL, 0x0001280800440020ULL, 0x00a1200800210106ULL,
+			0xc4080e0400011010ULL, 0x4000810102020080ULL, 0x081808c110508800ULL, 0x0002104100020880ULL,
+			0x10040c210808443aULL, 0x2050582410000409ULL, 0x0102010402080108ULL, 0x000840a018040500ULL,
+			0x0000010122021404ULL, 0x0002022042000104ULL, 0x812810012a080240ULL, 0x0002022042000104ULL,
+			0x0404008208208428ULL, 0x2000208808084080ULL, 0x40401a1500880008ULL, 0x8400000084240010ULL,
+			0x0009902014242201ULL, 0x140242c801410081ULL, 0x0092200801004200ULL, 0x80200102008110a1ULL,
+			0x2002020300887446ULL, 0x2002020300887446ULL, 0x0100001102884400ULL, 0x0800040080208818ULL,
+			0x01000110d0202a00ULL, 0x3030112002828200ULL, 0x00002008410800b2ULL, 0x2a44a0040c028a10ULL
+		} },
+		{ {
+			0x3500104100800024ULL, 0x0840001008200040ULL, 0x0680200048805000ULL, 0x0100200409001000ULL,
+			0x060004200a005810ULL, 0x420008108932000cULL, 0x420008108932000cULL, 0x0200008201003044ULL,
+			0x0012002041020080ULL, 0x0012002041020080ULL, 0x2002801000200080ULL, 0x0045801003810800ULL,
+			0x2309004801008410ULL, 0x0201800c00804600ULL, 0x88c20011c4020008ULL, 0x4102000051008c02ULL,
+			0x4041020022008040ULL, 0x4041020022008040ULL, 0x0140838020009004ULL, 0xa042020008244010ULL,
+			0x0500828008000400ULL, 0x6480080110400420ULL, 0x8110840008211042ULL, 0x0400020001046484ULL,
+			0x0421008200220041ULL, 0x0421008200220041ULL, 0x2000900280200080ULL, 0x6001000900201001ULL,
+			0x0680040080800800ULL, 0x0000040080800200ULL, 0x0280080400020110ULL, 0x8000004200008104ULL,
+			0x804100804200220aULL, 0x804100804200220aULL, 0x1008802008801000ULL, 0x0032082101001000ULL,
+			0x0000080080800401ULL, 0x0000800400800200ULL, 0x6201800100800200ULL, 0x8204004102002084ULL,
+			0xc582004100820020ULL, 0xc582004100820020ULL, 0x1020001000808020ULL, 0x04c8001000808009ULL,
+			0x3224008040080800ULL, 0x2802000510020008ULL, 0x8252020004010100ULL, 0x4c24010040820004ULL,
+			0x0500204289120200ULL, 0x0500204289120200ULL, 0x0500204289120200ULL, 0x0500204289120200ULL,
+			0x2469000408001100ULL, 0x0900020004008080ULL, 0x0802104201088400ULL, 0x00dd002200805100ULL,
+			0x0200228108401202ULL, 0x0200228108401202ULL, 0x0200228108401202ULL, 0x0101200500100039ULL,
+			0x80e2004410882102ULL, 0x80e2004410882102ULL, 0x80e2004410882102ULL, 0x80e2004410882102ULL
+		} }
+	} };
+
+	constexpr bit64 mask(piece pc, square sq)
 	{
-		// generating corresponding masks for each square
+		// generating the mask of relevant blockers, excluding the edges of the board
 
-		for (square sq{ H1 }; sq <= A8; sq += 1)
+		bit64 sq_bit{ bit::set(sq) };
+		bit64 msk{};
+		for (int dr{ pc ^ 1 }; dr < 8; dr += 2)
 		{
-			bit64 sq_bit{ bit::set(sq) };
-			for (int dr{ pc ^ 1 }; dr < 8; dr += 2)
+			bit64 ray{ sq_bit };
+			while (!(ray & shift::dr[dr].boarder))
 			{
-				bit64 ray{ sq_bit };
-				while (!(ray & shift::dr[dr].boarder))
-				{
-					slider[sq][pc].mask |= ray;
-					ray = bit::shift(ray, shift::dr[dr].shift);
-				}
+				msk |= ray;
+				ray = bit::shift(ray, shift::dr[dr].shift);
 			}
-			slider[sq][pc].mask ^= sq_bit;
 		}
+		return msk ^ sq_bit;
 	}
 
-	static void init_blocker(piece pc, std::vector<bit64> &blocker)
+	constexpr bit64 attack(piece pc, square sq, bit64 blocker)
 	{
-		// generating all possible blocker boards for each square
+		// generating the attacks from the square, considering the blocker board
 
-		struct split_mask { bool on; bit64 bit; };
-		for (auto &sq : slider)
+		bit64 att{};
+		for (int dr{ pc ^ 1 }; dr < 8; dr += 2)
 		{
-			std::vector<split_mask> split{};
-			bit64 mask{ sq[pc].mask };
-
-			while (mask)
+			bit64 ray{ bit::set(sq) };
+			bit64 stop{ shift::dr[dr].boarder | blocker };
+			while (!(ray & stop))
 			{
-				split.push_back(split_mask{ false, bit::set(bit::scan(mask)) });
-				mask &= mask - 1;
+				ray = bit::shift(ray, shift::dr[dr].shift);
+				att |= ray;
 			}
+		}
+		return att;
+	}
 
-			verify((int)split.size() >= 5 && (int)split.size() <= 12);
-			verify((int)split.size() == std::popcount(sq[pc].mask));
-
-			sq[pc].shift  = 64 - int(split.size());
-			sq[pc].offset = int(blocker.size());
+	constexpr uint64 index(lookup lu, piece pc, square sq, bit64 blocker)
+	{
+		// indexing the attack table of the square the same way as attack::by_slider()
+		// the PEXT instruction can't be evaluated at compile time & has to be emulated
 
-			// permuting through all possible combinations
+		if (lu == lookup::MAGIC)
+			return blocker * number[pc][sq] >> (64 - std::popcount(mask(pc, sq)));
 
-			int permutations{ 1 << split.size() };
-			for (int p{}; p < permutations; ++p)
-			{
-				mask = 0ULL;
-				for (uint32 b{}; b < split.size(); ++b)
-				{
-					if (p % (1 << b) == 0)
-						split[b].on = !split[b].on;
-
-					if (split[b].on)
-						mask |= split[b].bit;
-				}
-				blocker.push_back(mask);
-			}
-		}
+		uint64 idx{};
+		int b{};
+		for (bit64 msk{ mask(pc, sq) }; msk; msk &= msk - 1, ++b)
+			idx |= blocker & bit::set(bit::scan(msk)) ? 1ULL << b : 0ULL;
+		return idx;
 	}
 
-	static void init_attack(piece pc, const std::vector<bit64> &blocker, std::vector<bit64> &attack)
+	constexpr int attack_id(piece pc, square sq, bit64 blocker)
 	{
-		// generating all possible attacks from each square, considering the blocker boards
+		// numbering the distinct attacks from the square by the count of attacked squares along every ray
+		// a rook has at most 3 * 4 * 3 * 4 = 144 distinct attacks, so the number fits into 8 bits
+		// the number starts at 1 because 0 marks an empty entry
 
-		for (square sq{ H1 }; sq <= A8; sq += 1)
+		int id{};
+		for (int dr{ pc ^ 1 }; dr < 8; dr += 2)
 		{
-			bit64 sq_bit{ bit::set(sq) };
-			int permutations{ 1 << (64 - slider[sq][pc].shift) };
-
-			for (int p{}; p < permutations; ++p)
+			bit64 ray{ bit::set(sq) };
+			int len{}, cnt{};
+			for (bool stop{}; !(ray & shift::dr[dr].boarder); )
 			{
-				bit64 new_attack{};
-				for (int dr{ pc ^ 1 }; dr < 8; dr += 2)
-				{
-					bit64 ray{ sq_bit };
-					bit64 stop{ shift::dr[dr].boarder | blocker[slider[sq][pc].offset + p] };
-
-					while (!(ray & stop))
-					{
-						ray = bit::shift(ray, shift::dr[dr].shift);
-						new_attack |= ray;
-					}
-				}
-				attack.push_back(new_attack);
-				verify((int)attack.size() - 1 == slider[sq][pc].offset + p);
+				ray = bit::shift(ray, shift::dr[dr].shift);
+				len += 1;
+				cnt += !stop;
+				stop |= (ray & blocker) != 0;
 			}
+			id = id * (len ? len : 1) + (cnt ? cnt - 1 : 0);
 		}
+		return id + 1;
 	}
 
-	static void init_magic(piece pc, const std::vector<bit64> &blocker, const std::vector<bit64> &attack)
+	constexpr attack_entry table_entry(piece pc, square sq, bit64 blocker)
 	{
-		// finding fitting magic numbers
-		// idea from Tord Romstad:
-		// https://www.chessprogramming.org/Looking_for_Magics
+		// the entries of the attack tables are either the attacks themselves or their number
 
-		rand_64xor rand_gen{};
-		bool fail{};
-
-		for (square i{ H1 }; i <= A8; i += 1)
-		{
-			auto &sq{ slider[i][pc] };
-			rand_gen.new_seed(i);
-			
-			int permutations{ 1 << (64 - sq.shift) };
-			verify(permutations >= (1 << 5) && permutations <= (1 << 12));
-			
-			do
-			{
-				do sq.magic = rand_gen.sparse64();
-				while (std::popcount((sq.mask * sq.magic) & 0xff00000000000000) < 6);
-
-				fail = false;
-				std::vector<bit64> save_attack(permutations);
-
-				for (int p{}; !fail && p < permutations; ++p)
-				{
-					int index{ int(blocker[sq.offset + p] * sq.magic >> sq.shift) };
-					verify(index <= permutations);
-
-					if (!save_attack[index])
-						 save_attack[index] = attack[sq.offset + p];
-
-					else if (save_attack[index] != attack[sq.offset + p])
-					{
-						fail = true;
-						break;
-					}
-				}
-			} while (fail);
-		}
+#if defined(COMPACT_SLIDERS)
+		return attack_entry(attack_id(pc, sq, blocker));
+#else
+		return attack(pc, sq, blocker);
+#endif
 	}
 
-	static void init_index(piece pc, std::vector<bit64> &blocker, std::vector<bit64> &attack_temp)
+	template<lookup lu, piece pc, square sq>
+	constexpr auto init_attack()
 	{
-		// using the created magic numbers to index the attack table
-		// if the BMI2 instruction PEXT is enabled, using it instead for faster performance
+		// generating the attack table of one square by permuting through all possible blocker boards
+		// every square gets its own table to keep the compile-time evaluation within the compiler limits
 
-		for (auto &sq : slider)
+		constexpr bit64 msk{ mask(pc, sq) };
+		std::array<attack_entry, 1ULL << std::popcount(msk)> table{};
+		bit64 blocker{};
+		do
 		{
-			int permutations{ 1 << (64 - sq[pc].shift) };
-			for (int p{}; p < permutations; ++p)
-			{
-#if defined(PEXT)
-				uint64 index{ _pext_u64(blocker[sq[pc].offset + p], sq[pc].mask) };
-#else
-				uint64 index{ blocker[sq[pc].offset + p] * sq[pc].magic >> sq[pc].shift };
-#endif
-				attack_table[sq[pc].offset + (int)index] = attack_temp[sq[pc].offset + p];
-			}
-		}
+			auto idx{ index(lu, pc, sq, blocker) };
+			verify(!table[idx] || table[idx] == table_entry(pc, sq, blocker));
+			table[idx] = table_entry(pc, sq, blocker);
+			blocker = (blocker - msk) & msk;
+		} while (blocker);
+		return table;
 	}
-}
 
-void magic::init_table()
-{
-	// indexing the attack tables for bishops and rooks
-	// starting by initializing temporary attack-tables & blocker-tables
+	template<lookup lu, piece pc, square sq>
+	constexpr auto attack_table{ init_attack<lu, pc, sq>() };
+
+#if defined(COMPACT_SLIDERS)
 
-	attack_table.resize(size::table);
+	template<piece pc, square sq>
+	constexpr auto init_distinct()
+	{
+		// generating the table of all distinct attacks of one square, shared by both index functions
 
-	std::vector<bit64> attack_temp{};
-	attack_temp.reserve(size::table);
+		constexpr bit64 msk{ mask(pc, sq) };
+		constexpr int size{ attack_id(pc, sq, 0ULL) + 1 };
+		std::array<bit64, size> table{};
+		bit64 blocker{};
+		do
+		{
+			table[attack_id(pc, sq, blocker)] = attack(pc, sq, blocker);
+			blocker = (blocker - msk) & msk;
+		} while (blocker);
+		return table;
+	}
 
-	std::vector<bit64> blocker{};
-	blocker.reserve(size::table);
+	template<piece pc, square sq>
+	constexpr auto distinct_table{ init_distinct<pc, sq>() };
 
-	// generating magic numbers & indexing their final attack tables
+#endif
 
-	for (piece pc : { BISHOP, ROOK })
+	template<piece pc, square sq>
+	constexpr sq_entry init_entry()
 	{
-		init_mask(pc);
-		init_blocker(pc, blocker);
-		init_attack(pc, blocker, attack_temp);
-		init_magic(pc, blocker, attack_temp);
-		init_index(pc, blocker, attack_temp);
+		// the tables indexed by PEXT are only generated if PEXT can be selected at startup
+
+		sq_entry entry{};
+		entry.mask   = mask(pc, sq);
+		entry.magic  = number[pc][sq];
+		entry.attack = attack_table<lookup::MAGIC, pc, sq>.data();
+		entry.shift  = 64 - std::popcount(mask(pc, sq));
+#if defined(PEXT_AVAILABLE)
+		entry.attack_pext = attack_table<lookup::PEXT, pc, sq>.data();
+#endif
+#if defined(COMPACT_SLIDERS)
+		entry.distinct = distinct_table<pc, sq>.data();
+#endif
+		return entry;
+	}
+
+	template<std::size_t... sq>
+	constexpr std::array<std::array<sq_entry, 2>, 64> init_slider(std::index_sequence<sq...>)
+	{
+		return { { { { init_entry<BISHOP, square(sq)>(), init_entry<ROOK, square(sq)>() } }... } };
 	}
 }
+
+// the attack tables of bishops & rooks take ~860 KB per index function
+// in compact builds they take ~105 KB per index function plus ~50 KB for the distinct attacks
+
+constexpr std::array<std::array<magic::sq_entry, 2>, 64> magic::slider{ init_slider(std::make_index_sequence<64>{}) };
+
+const std::array<const char*, 2> magic::lookup_name{ { "magic", "pext" } };
+
+void magic::init_lookup()
+{
+	// selecting the fastest index function that the CPU supports
+
+#if defined(PEXT_AVAILABLE)
+	mode = cpu::bmi2() && !cpu::slow_pext() ? lookup::PEXT : lookup::MAGIC;
+#else
+	mode = lookup::MAGIC;
+#endif
+}
\ No newline at end of file
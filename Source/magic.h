@@ -19,35 +19,71 @@
 #pragma once
 
 #include <array>
-#include <vector>
 
 #include "types.h"
 
+// PEXT can be used on all x86-64 CPUs with BMI2, the binary decides at startup whether to use it
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PEXT_AVAILABLE
+#endif
+
 // setting up the magic index function for fast move generation of sliding pieces
 // the tables are indexed using the "fancy" approach:
 // https://www.chessprogramming.org/Magic_Bitboards
 
 namespace magic
 {
+	// the attack tables hold the attacks themselves by default
+	// compact builds (SLIDERS=compact) store the 8-bit number of the attack among all distinct attacks of the square instead,
+	// which shrinks the tables to less than a fifth at the cost of a second dependent load
+
+#if defined(COMPACT_SLIDERS)
+	using attack_entry = uint8;
+#else
+	using attack_entry = bit64;
+#endif
+
 	// to be calculated for each square:
-	// attack mask, magic indexing number, offset of the array, shift of the magic key
+	// attack mask, magic indexing number, attack table of the square, shift of the magic key,
+	// attack table of the square indexed by PEXT, distinct attacks of the square in compact builds
 
 	struct sq_entry
 	{
 		bit64 mask;
 		bit64 magic;
-		int offset;
+		const attack_entry* attack;
 		int shift;
+		const attack_entry* attack_pext;
+#if defined(COMPACT_SLIDERS)
+		const bit64* distinct;
+#endif
 	};
 
 	enum piece { BISHOP, ROOK };
 
-	// tables with all information for magic move generation after initialization
+	// table with all information for magic move generation
+	// it is generated at compile time together with the attack tables & stored read-only in the binary
 
-	inline std::array<std::array<sq_entry, 2>, 64> slider{};
-	inline std::vector<bit64> attack_table{};
+	extern const std::array<std::array<sq_entry, 2>, 64> slider;
 
-	// indexing the magic number attack tables
+	// index functions of the attack tables, the fastest one available is selected at startup
+	// PEXT is only used if the CPU supports BMI2 & doesn't execute PEXT in microcode
 
-	void init_table();
+	enum class lookup { MAGIC, PEXT };
+	inline lookup mode{ lookup::MAGIC };
+	extern const std::array<const char*, 2> lookup_name;
+
+	void init_lookup();
+
+	// turning an entry of the attack tables into the attack bitboard
+
+	inline bit64 expand([[maybe_unused]] const sq_entry& entry, attack_entry att)
+	{
+#if defined(COMPACT_SLIDERS)
+		return entry.distinct[att];
+#else
+		return att;
+#endif
+	}
 }
@@ -21,10 +21,10 @@
 #include "search.h"
 #include "trans.h"
 #include "syzygy.h"
+#include "bitbase.h"
 #include "eval.h"
 #include "misc.h"
 #include "magic.h"
-#include "bit.h"
 #include "zobrist.h"
 #include "uci.h"
 #include "main.h"
@@ -37,16 +37,16 @@ int main([[maybe_unused]] int argc, char* argv[])
 	std::cout << "DEBUG flag set" << std::endl;
 #endif
 
-	// initializing everything before entering the UCI communication loop
+	// initializing everything that isn't generated at compile time before entering the UCI communication loop
 
-	bit::init_masks();
-	zobrist::init_keys();
+	magic::init_lookup();
+	zobrist::init_cuckoo();
 	trans::create(uci::hash_size);
-	magic::init_table();
 	filesystem::init_path(argv[0]);
 	eval::mirror_tables();
 	search::init_params();
 	syzygy::init_tb(uci::syzygy_path);
+	bitbase::init();
 
 	uci::loop();
 	return 0;
@@ -24,7 +24,7 @@
 
 namespace
 {
-    [[maybe_unused]] void verify_expr(const bool& condition, const char* expr, const char* file, unsigned long line)
+    [[maybe_unused]] constexpr void verify_expr(const bool& condition, const char* expr, const char* file, unsigned long line)
     {
         // if an expression cannot be verified, the output with information about the failed expression
         // can be redirected to a log file with the UCI command 'setoption Log value true'
@@ -19,6 +19,13 @@
 #include <filesystem>
 #include <streambuf>
 #include <string>
+#include <array>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <cpuid.h>
+#endif
 
 #include "main.h"
 #include "types.h"
@@ -132,6 +139,58 @@ void memory::prefetch(char* address)
 #endif
 }
 
+// querying the CPU
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+namespace cpu
+{
+	static std::array<uint32, 4> cpuid(uint32 leaf)
+	{
+		// returning the registers EAX, EBX, ECX & EDX of the CPUID instruction
+
+		std::array<uint32, 4> reg{};
+#if defined(_MSC_VER)
+		std::array<int, 4> r{};
+		__cpuidex(r.data(), int(leaf), 0);
+		for (int i{}; i < 4; ++i)
+			reg[i] = uint32(r[i]);
+#else
+		__cpuid_count(leaf, 0, reg[0], reg[1], reg[2], reg[3]);
+#endif
+		return reg;
+	}
+}
+
+#endif
+
+bool cpu::bmi2()
+{
+	// BMI2 support is reported in bit 8 of EBX of leaf 7
+
+#if defined(_M_X64) || defined(__x86_64__)
+	return cpuid(0)[0] >= 7 && (cpuid(7)[1] & (1U << 8));
+#else
+	return false;
+#endif
+}
+
+bool cpu::slow_pext()
+{
+	// AMD & Hygon CPUs before Zen 3 (family 19h) execute PEXT in microcode with a latency of up to ~300 cycles
+
+#if defined(_M_X64) || defined(__x86_64__)
+	uint32 vendor{ cpuid(0)[1] };
+	uint32 eax{ cpuid(1)[0] };
+	uint32 family{ (eax >> 8) & 0xf };
+	if (family == 0xf)
+		family += (eax >> 20) & 0xff;
+	return (vendor == 0x68747541 || vendor == 0x6f677948) && family < 0x19;
+#else
+	return false;
+#endif
+}
+
 // overriding stream-buffer functions to enable logging
 
 int syncbuf::sync()
@@ -191,38 +250,9 @@ void synclog::stop()
 
 // pseudo random number generation
 
-void rand_64xor::new_seed(square sq)
-{
-	// getting a new seed for the PRNG depending on the square
-	// this speeds up magic number generation significantly; idea from Marco Costalba:
-	// http://www.talkchess.com/forum3/viewtopic.php?t=39298
-
-	verify(type::sq(sq));
-	seed = magic_seed[sq >> 2];
-}
-
-bit64 rand_64xor::rand64()
-{
-	// xor-shift pseudo random number generation
-	// idea from George Marsaglia:
-	// https://www.jstatsoft.org/article/view/v008i14
-
-	seed ^= seed >> 12;
-	seed ^= seed << 25;
-	seed ^= seed >> 27;
-	return  seed * 0x2545f4914f6cdd1dULL;
-}
-
-uint64 rand_64xor::sparse64()
-{
-	// creating a sparse magic number
-
-	return rand64() & rand64() & rand64();
-}
-
 bit64 rand_64::rand64()
 {
-	// creating a Zobrist hash key
+	// creating a uniformly distributed random number
 
 	return uniform(rand_gen);
 }
@@ -75,6 +75,16 @@ namespace memory
 	void prefetch(char* address);
 }
 
+// providing information about the CPU
+
+namespace cpu
+{
+	// checking whether the BMI2 instruction PEXT is supported & whether it is executed in microcode
+
+	bool bmi2();
+	bool slow_pext();
+}
+
 // providing logging functionality
 
 struct syncbuf : public std::streambuf
@@ -111,31 +121,30 @@ public:
 class rand_64xor
 {
 	// pseudo random number generation through xor-shift
-	// used to generate "magic" index numbers
+	// usable at compile time to generate the Zobrist hash keys
 
 private:
-	// using pre-calculated seeds to speed up magic number generation
-
-	static constexpr std::array<bit64, 16> magic_seed
-	{ {
-		0x5dd4569, 0x33180c2, 0x1ab24ce, 0x4fc6fd8,
-		0x559921d, 0x0db6850, 0x0c6e669, 0x4e47fcf,
-		0x252b1fa, 0x4319b7f, 0x201818c, 0x3dd84f7,
-		0x5ede0dc, 0x1321cc8, 0x2b9b062, 0x290b5b5
-	} };
-
 	bit64 seed{};
-	bit64 rand64();
 
 public:
-	void new_seed(square sq);
-	bit64 sparse64();
+	constexpr rand_64xor(bit64 seed) : seed(seed) {}
+
+	constexpr bit64 rand64()
+	{
+		// idea from George Marsaglia:
+		// https://www.jstatsoft.org/article/view/v008i14
+
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		return  seed * 0x2545f4914f6cdd1dULL;
+	}
 };
 
 class rand_64
 {
 	// pseudo random number generation with standard library functions
-	// used to generate Zobrist hash keys
+	// used to generate random network weights & history scores for testing
 
 private:
 	std::mt19937_64 rand_gen;
@@ -116,19 +116,28 @@ struct move_var
 	bool tb_root{};
 };
 
+// provisional variation of one ply of the search, used as a row of the triangular PV-table
+
+struct move_line
+{
+	std::array<move, lim::dt> mv;
+	int cnt;
+};
+
 // search stack contains mostly various move lists
 
 struct sstack
 {
 	depth dt{};
 	score sc{ score::NONE };
+	std::array<bit64, 2> att{};
 	move  mv{};
-	std::array<std::array<int, 64>, 6>* cont_mv{};
+	std::array<std::array<int16, 64>, 6>* cont_mv{};
 	move singular_mv{};
 	killer_list killer{};
-	struct null_move { bit64 ep{}; square sq{}; } null_mv{};
-	move_list quiet_mv{};
-	move_list capture_mv{};
+	struct null_move { bit64 ep{}; square sq{}; int cnt{}; } null_mv{};
+	std::array<move, lim::tried_quiets> quiet_mv{};
+	std::array<move, lim::tried_captures> capture_mv{};
 	bool pruning{ true };
 	int fail_high_cnt{};
 };
\ No newline at end of file
@@ -214,10 +214,22 @@ template<mode md> int gen<md>::restore_loosing()
 	return cnt.mv;
 }
 
-template<mode md> template<stage st> bit64 gen<md>::pawn_mask()
+template<mode md> template<stage st> void gen<md>::pawns()
+{
+	// dispatching pawn move generation to the side to move
+	// all colour-dependent shifts, masks & table indices become compile-time constants
+
+	if (pos.cl == WHITE)
+		pawns<st, WHITE>();
+	else
+		pawns<st, BLACK>();
+}
+
+template<mode md> template<stage st, color cl> bit64 gen<md>::pawn_mask()
 {
 	// generating the appropriate mask depending on the type of pawn move
 
+	constexpr color cl_x{ cl ^ 1 };
 	if constexpr (st == stage::QUIET)
 		return evasions & ~bit::rank_promo & ~pos.side[BOTH];
 	if constexpr (st == stage::QUIET_PROMO_ALL)
@@ -225,34 +237,35 @@ template<mode md> template<stage st> bit64 gen<md>::pawn_mask()
 	if constexpr (st == stage::QUIET_PROMO_QUEEN)
 		return evasions & bit::rank_promo & ~pos.side[BOTH];
 	if constexpr (st == stage::CAPTURE)
-		return evasions & ~bit::rank_promo & pos.side[pos.cl_x];
+		return evasions & ~bit::rank_promo & pos.side[cl_x];
 	if constexpr (st == stage::CAPTURE_PROMO_ALL)
-		return evasions & bit::rank_promo & pos.side[pos.cl_x];
+		return evasions & bit::rank_promo & pos.side[cl_x];
 	if constexpr (st == stage::CAPTURE_PROMO_QUEEN)
-		return evasions & bit::rank_promo & pos.side[pos.cl_x];
+		return evasions & bit::rank_promo & pos.side[cl_x];
 	if constexpr (st == stage::ENPASSANT)
-		return bit::shift(evasions, shift::push1x[pos.cl]) & ~bit::rank_promo & pos.ep_rear;
+		return bit::shift(evasions, shift::push1x[cl]) & ~bit::rank_promo & pos.ep_rear;
 }
 
-template<mode md> template<stage st> void gen<md>::pawns()
+template<mode md> template<stage st, color cl> void gen<md>::pawns()
 {
 	// generating pawn moves
 
 	static_assert(st == pawn_gen::gen_detail[int(st)][0].st);
-	bit64 mask{ pawn_mask<st>() };
+	verify(pos.cl == cl);
+	bit64 mask{ pawn_mask<st, cl>() };
 
 	for (auto& pawn : pawn_gen::gen_detail[int(st)])
 	{
-		bit64 targets{ mask & bit::shift(pos.pieces[piece::PAWN] & pos.side[pos.cl] & pawn.mask[pos.cl],
-			pawn.shift[pos.cl]) };
+		bit64 targets{ mask & bit::shift(pos.pieces[piece::PAWN] & pos.side[cl] & pawn.mask[cl],
+			pawn.shift[cl]) };
     if constexpr (st == stage::QUIET)
 			if (pawn.shift == shift::push2x)
-				targets &= ~bit::shift(bit::rank_push2x[pos.cl] & pos.side[BOTH], shift::push1x[pos.cl]);
+				targets &= ~bit::shift(bit::rank_push2x[cl] & pos.side[BOTH], shift::push1x[cl]);
 
 		while (targets)
 		{
 			square sq2{ bit::scan(targets) };
-			square sq1{ sq2 - pawn.shift[0] * (1 - 2 * pos.cl) };
+			square sq1{ sq2 - pawn.shift[0] * (1 - 2 * cl) };
 			piece vc{ pos.piece_on[sq2] };
             if constexpr (st == stage::ENPASSANT)
                 vc = PAWN;
@@ -261,9 +274,9 @@ template<mode md> template<stage st> void gen<md>::pawns()
 			{
                     if constexpr (st == stage::QUIET_PROMO_ALL || st == stage::CAPTURE_PROMO_ALL)
                         for (flag fl{ pawn.fl }; fl >= PROMO_KNIGHT; fl = fl - 1)
-                            mv[cnt.mv++] = move{ sq1, sq2, PAWN, vc, pos.cl, fl };
+                            mv[cnt.mv++] = move{ sq1, sq2, PAWN, vc, cl, fl };
                     else
-                        mv[cnt.mv++] = move{ sq1, sq2, PAWN, vc, pos.cl, pawn.fl };
+                        mv[cnt.mv++] = move{ sq1, sq2, PAWN, vc, cl, pawn.fl };
 			}
 			targets &= targets - 1;
 		}
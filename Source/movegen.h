@@ -88,8 +88,9 @@ public:
 private:
 	// actual move generating functions
 
-	template<stage st> bit64 pawn_mask();
 	template<stage st> void pawns();
+	template<stage st, color cl> bit64 pawn_mask();
+	template<stage st, color cl> void pawns();
 	template<stage st> void pieces(std::initializer_list<piece> pc);
 	void castle();
 };
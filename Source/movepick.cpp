@@ -16,6 +16,15 @@
 */
 
 
+#include <algorithm>
+#include <limits>
+#include <array>
+#include <functional>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "main.h"
 #include "types.h"
 #include "uci.h"
@@ -39,11 +48,30 @@ void rootpick::rearrange_list(move pv_mv, move multipv_mv)
 		sort.include_moves();
 }
 
+void rootpick::restore(const std::vector<rootsort::root_node>& nodes)
+{
+	// taking over the node counts & weights of the root node moves from the previous search
+
+	for (auto& prior : nodes)
+	{
+		for (int i{}; i < mv_cnt(); ++i)
+		{
+			if (sort.root[i].mv == prior.mv)
+			{
+				sort.root[i].nodes  = prior.nodes;
+				sort.root[i].weight = prior.weight;
+				break;
+			}
+		}
+	}
+}
+
 template<mode md> void movepick<md>::gen_weight()
 {
 	// generating and weighting the moves of the current stage
 
 	list.cnt.mv = list.cnt.capture = list.cnt.promo = list.cnt.duplicate = 0;
+	cnt.sorted = cnt.picked = 0;
 	verify(cnt.cycles >= 0);
 
 	switch (st[cnt.cycles])
@@ -69,6 +97,7 @@ template<mode md> void movepick<md>::gen_weight()
 	case genstage::QUIET:
 		cnt.mv = list.gen_quiet();
 		weight.quiet();
+		cnt.sorted = weight.partial_sort(history::max * 4);
 		break;
 
 	case genstage::LOOSING:
@@ -95,52 +124,150 @@ template<mode md> void movepick<md>::gen_weight()
 	cnt.attempts = cnt.mv;
 }
 
-template move movepick<mode::LEGAL>::next();
-template move movepick<mode::PSEUDOLEGAL>::next();
-template<mode md> move movepick<md>::next()
+template<mode md> int movepick<md>::best_entry() const
 {
-	// cycling through move-generation stages and picking the highest-scored moves
+	// scanning the unsorted part of the list for the highest entry
+	// picked entries have been set to zero
+
+	const uint64* entry{ weight.entry.data() };
+	int begin{ cnt.sorted }, end{ cnt.mv };
+	uint64 best{};
 
-	while (cnt.attempts == 0)
+#if defined(__AVX2__)
+
+	// comparing 4 entries at once if the list is long enough
+	// flipping the sign bit allows comparing unsigned entries with the signed instruction
+
+	if (end - begin >= 16)
 	{
-		cnt.cycles += 1;
-		if (cnt.cycles >= cnt.max_cycles)
-			return move{};
-		gen_weight();
+		__m256i sign{ _mm256_set1_epi64x(std::numeric_limits<int64>::min()) };
+		__m256i max { _mm256_xor_si256(sign, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entry + begin))) };
+
+		for (begin += 4; begin + 4 <= end; begin += 4)
+		{
+			__m256i next{ _mm256_xor_si256(sign, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entry + begin))) };
+			max = _mm256_blendv_epi8(max, next, _mm256_cmpgt_epi64(next, max));
+		}
+
+		std::array<uint64, 4> lane{};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lane.data()), _mm256_xor_si256(sign, max));
+		best = std::max({ lane[0], lane[1], lane[2], lane[3] });
 	}
+#endif
+
+	for (; begin < end; ++begin)
+		best = std::max(best, entry[begin]);
 
-	// finding the highest-scored move
+	// partial sorting shuffles the unsorted entries, so the position of the highest entry has to be searched for
 
-	int best_idx{ -1 };
-	uint32 best_score{};
+	if (!sort<md>::weighted(best))
+		return -1;
+	return int(std::find(entry + cnt.sorted, entry + cnt.mv, best) - entry);
+}
+
+template bool movepick<mode::LEGAL>::see_above(move mv, score margin) const;
+template bool movepick<mode::PSEUDOLEGAL>::see_above(move mv, score margin) const;
+template<mode md> bool movepick<md>::see_above(move mv, score margin) const
+{
+	// avoiding a repeated SEE calculation of captures that have already been evaluated during the weighting
+
+	verify(see_sc == score::NONE || see_sc == attack::see(list.pos, mv));
 
-	for (int i{}; i < cnt.mv; ++i)
+	if (see_sc != score::NONE)
+		return see_sc >= margin;
+
+	// quiet moves cannot loose material if neither the origin nor the target square is attacked
+	// this can be read from the attack tables of the evaluation, which are empty if there was no evaluation
+
+	if (bit64 att{ weight.node.stack->att[list.pos.cl_x] }; att && mv.quiet() && margin <= 0)
 	{
-		if (weight.sc[i] > best_score)
+		if (!(att & (bit::set(mv.sq1()) | bit::set(mv.sq2()))))
 		{
-			best_score = weight.sc[i];
-			best_idx = i;
+			verify(attack::see_above(list.pos, mv, margin));
+			return true;
 		}
 	}
+	return attack::see_above(list.pos, mv, margin);
+}
 
-	if (best_idx == -1)
+template bool movepick<mode::LEGAL>::escape(move mv) const;
+template bool movepick<mode::PSEUDOLEGAL>::escape(move mv) const;
+template<mode md> bool movepick<md>::escape(move mv) const
+{
+	// a piece that is not attacked doesn't have to escape
+
+	if (bit64 att{ weight.node.stack->att[list.pos.cl_x] }; att && !(att & bit::set(mv.sq1())))
 	{
-		// even though there are still moves in the list of the current stage that have not been selected,
-		// next() will be moving on to the next generation stage, because hash-, killer- and counter-moves
-		// are generated twice, and moves with negative SEE are being deferred to the 'loosing' stage
-		// after their generation, so all of these can be skipped safely
-
-		verify(cnt.attempts == list.cnt.duplicate + (st[cnt.cycles] == genstage::WINNING ? list.cnt.loosing : 0)
-			|| uci::multipv > 1);
-		cnt.attempts = 0;
-		return next();
+		verify(!attack::escape(list.pos, mv));
+		return false;
 	}
+	return attack::escape(list.pos, mv);
+}
 
-	verify(cnt.attempts >= 1);
-	verify(cnt.mv == list.cnt.mv);
+template move movepick<mode::LEGAL>::next();
+template move movepick<mode::PSEUDOLEGAL>::next();
+template<mode md> move movepick<md>::next()
+{
+	// cycling through move-generation stages and picking the highest-scored moves
+	// the loop starts over whenever a stage runs out of moves or a quiet move gets skipped
 
-	cnt.attempts -= 1;
-	hits += 1;
-	weight.sc[best_idx] = 0ULL;
-	return list.mv[best_idx];
+	while (true)
+	{
+		while (cnt.attempts == 0)
+		{
+			cnt.cycles += 1;
+			if (cnt.cycles >= cnt.max_cycles)
+				return move{};
+			gen_weight();
+		}
+
+		// sorting all remaining quiet moves at once if only the ones giving check are still of interest
+
+		if (cnt.skip && st[cnt.cycles] == genstage::QUIET && cnt.sorted < cnt.mv)
+		{
+			std::sort(weight.entry.begin() + cnt.picked, weight.entry.begin() + cnt.mv, std::greater<uint64>{});
+			cnt.sorted = cnt.mv;
+		}
+
+		// finding the highest-weighted move, either in the sorted part of the list or by scanning the rest of it
+
+		int best_idx{ cnt.picked < cnt.sorted ? cnt.picked++ : best_entry() };
+
+		if (best_idx == -1 || !sort<md>::weighted(weight.entry[best_idx]))
+		{
+			// even though there are still moves in the list of the current stage that have not been selected,
+			// next() will be moving on to the next generation stage, because hash-, killer- and counter-moves
+			// are generated twice, and moves with negative SEE are being deferred to the 'loosing' stage
+			// after their generation, so all of these can be skipped safely
+
+			verify(cnt.attempts == list.cnt.duplicate + (st[cnt.cycles] == genstage::WINNING ? list.cnt.loosing : 0)
+				|| uci::multipv > 1);
+			cnt.attempts = 0;
+			continue;
+		}
+
+		verify(cnt.attempts >= 1);
+		verify(cnt.mv == list.cnt.mv);
+
+		cnt.attempts -= 1;
+		hits += 1;
+
+		move best_mv{ sort<md>::entry_mv(weight.entry[best_idx]) };
+		verify(best_mv == list.mv[sort<md>::entry_idx(weight.entry[best_idx])]);
+
+		// only the tactical stages of the main search know the SEE of their captures
+
+		see_sc = (st[cnt.cycles] == genstage::WINNING || st[cnt.cycles] == genstage::LOOSING) && best_mv.capture()
+			? score(weight.see[sort<md>::entry_idx(weight.entry[best_idx])]) : score::NONE;
+		weight.entry[best_idx] = 0ULL;
+
+		// skipping quiet moves that don't give check if requested by the search
+		// they are still counted as picked, because the search would have pruned them instead
+		// the move excluded by the singular extension search is left for the search to be discounted
+
+		if (cnt.skip && st[cnt.cycles] == genstage::QUIET
+			&& best_mv != weight.node.stack->singular_mv && !list.pos.gives_check(best_mv))
+			continue;
+		return best_mv;
+	}
 }
\ No newline at end of file
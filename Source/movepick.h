@@ -58,6 +58,11 @@ public:
 	void rearrange_list(move pv_mv, move multipv_mv);
 	void sort_tb() { sort.sort_moves(); };
 
+	// saving & restoring the root node statistics to warm-start the next search of the same position
+
+	void save(std::vector<rootsort::root_node>& nodes) const { nodes.assign(sort.root.begin(), sort.root.begin() + mv_cnt()); };
+	void restore(const std::vector<rootsort::root_node>& nodes);
+
 	// picking the next move from the list
 
 	rootsort::root_node*  next() { return mv_n < mv_cnt() ? &sort.root[mv_n++] : nullptr; };
@@ -86,12 +91,23 @@ private:
 		int max_cycles{};
 		int attempts{};
 		int mv{};
+		int sorted{};
+		int picked{};
+		bool skip{};
 	} cnt;
 
+	// exact SEE of the last picked move, if it has already been calculated during the weighting
+
+	score see_sc{ score::NONE };
+
 	// generating and weighting the moves
 
 	void gen_weight();
 
+	// finding the highest-weighted entry of the list
+
+	int best_entry() const;
+
 public:
 	// alpha-beta search
 
@@ -113,6 +129,18 @@ public:
 public:
 	void revert(board& pos) { pos = list.pos; hits -= 1; }
 
+	// skipping all remaining quiet moves except checks, because the search is going to prune them anyway
+
+	void skip_quiets() { cnt.skip = true; }
+
+	// testing the last picked move through SEE, reusing its exact value from the weighting if possible
+
+	bool see_above(move mv, score margin) const;
+
+	// testing whether a quiet move escapes a capture, reusing the attack tables of the evaluation if possible
+
+	bool escape(move mv) const;
+
 	// picking the highest weighted move
 	// if there is none left, further generation and weighting is initialized
 
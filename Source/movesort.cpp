@@ -19,6 +19,10 @@
 #include <array>
 #include <algorithm>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "main.h"
 #include "types.h"
 #include "attack.h"
@@ -27,6 +31,8 @@
 #include "move.h"
 #include "movesort.h"
 
+static_assert(lim::moves <= 256);
+
 void rootsort::sort_moves()
 {
 	// sorting the root nodes
@@ -38,7 +44,7 @@ void rootsort::sort_static()
 {
 	// assigning a base value to all root node moves through static evaluation (~10 Elo)
 
-	kingpawn_hash hash(kingpawn_hash::ALLOCATE_NONE);
+	eval_hash hash(eval_hash::ALLOCATE_NONE);
 	for (int i{}; i < list.cnt.mv; ++i)
 	{
 		pos.new_move(list.mv[i]);
@@ -117,6 +123,30 @@ template<mode md> uint32 sort<md>::mvv_lva_promo(move mv) const
     return uint32(attack::value[mv.vc()] + attack::value[mv.promo_pc()] - attack::value[PAWN] * 2);
 }
 
+template<mode md> void sort<md>::assign(int i, uint32 sc)
+{
+	// packing the weight, the inverted list index and the move into one entry
+
+	verify(i >= 0 && i < int(lim::moves));
+	verify(list.mv[i].raw() <= 0x3fffff);
+
+	entry[i] = uint64(sc) << 32 | uint64(lim::moves - 1 - i) << 22 | list.mv[i].raw();
+}
+
+template<mode md> uint32 sort<md>::quiet_hist(move mv) const
+{
+	// weighting a quiet move through the main and the continuation history tables
+
+	move mv_1{ (node.stack - 1)->mv };
+	move mv_2{ (node.stack - 2)->mv };
+
+	uint32 sc{ history::max * 4 };
+	sc += (*node.hist).main[list.pos.cl][mv.sq1()][mv.sq2()];
+	sc += mv_1 ? (*node.hist).continuation[mv_1.pc()][mv_1.sq2()][mv.pc()][mv.sq2()][0] : 0;
+	sc += mv_2 ? (*node.hist).continuation[mv_2.pc()][mv_2.sq2()][mv.pc()][mv.sq2()][1] : 0;
+	return sc;
+}
+
 template<mode md> bool sort<md>::previous(move mv) const
 {
 	// checking if a quiet move has already been searched in a previous stage
@@ -137,7 +167,7 @@ template<mode md> void sort<md>::hash()
 	{
 		verify(list.cnt.mv == 1);
 		verify(list.mv[0] == node.hash);
-		sc[0] = 1;
+		assign(0, 1);
 	}
 }
 
@@ -155,22 +185,27 @@ template<mode md> void sort<md>::tactical_see()
 		verify(list.mv[i].capture());
 		if (list.mv[i] == node.hash)
 		{
-			sc[i] = 0;
+			assign(i, 0);
 			list.cnt.duplicate += 1;
+			continue;
 		}
-		else if (!attack::see_above(list.pos, list.mv[i], score(0)))
+
+		see[i] = int16(attack::see(list.pos, list.mv[i]));
+		if (see[i] < 0)
 		{
 			// deferring loosing captures to a later stage (~200 Elo)
 
-			sc[i] = 0;
-			list.mv[lim::moves - ++list.cnt.loosing] = list.mv[i];
+			assign(i, 0);
+			list.cnt.loosing += 1;
+			list.mv[lim::moves - list.cnt.loosing] = list.mv[i];
+			see[lim::moves - list.cnt.loosing] = see[i];
 		}
 		else
 		{
 			// sorting all non-loosing captures with capture history (~20 Elo)
 
-			sc[i] = history::max * 2
-				+ (*node.hist).capture[list.pos.cl][list.mv[i].pc()][list.mv[i].sq2()][list.mv[i].vc()];
+			assign(i, history::max * 2
+				+ (*node.hist).capture[list.pos.cl][list.mv[i].pc()][list.mv[i].sq2()][list.mv[i].vc()]);
 		}
 	}
 
@@ -179,13 +214,14 @@ template<mode md> void sort<md>::tactical_see()
 	for (int i{ list.cnt.capture }; i < list.cnt.capture + list.cnt.promo; ++i)
 	{
 		verify(list.mv[i].promo());
+		see[i] = int16(score::NONE);
 		if (list.mv[i] == node.hash)
 		{
-			sc[i] = 0;
+			assign(i, 0);
 			list.cnt.duplicate += 1;
 		}
 		else
-			sc[i] = mvv_lva_promo(list.mv[i]);
+			assign(i, mvv_lva_promo(list.mv[i]));
 	}
 }
 
@@ -201,11 +237,11 @@ template<mode md> void sort<md>::killer()
 		verify(list.mv[i].quiet());
 		if (list.mv[i] == node.hash)
 		{
-			sc[i] = 0;
+			assign(i, 0);
 			list.cnt.duplicate += 1;
 		}
 		else
-			sc[i] = list.cnt.mv - i;
+			assign(i, list.cnt.mv - i);
 	}
 }
 
@@ -215,32 +251,108 @@ template<mode md> void sort<md>::quiet()
 {
 	// weighting quiet moves through history heuristic (~210 Elo)
 
+	int i{};
+
+#if defined(__AVX2__)
+
+	// gathering the history scores of 8 moves at once
+
 	move mv_1{ (node.stack - 1)->mv };
 	move mv_2{ (node.stack - 2)->mv };
-    piece  pc_1{ mv_1.pc()  }, pc_2{ mv_2.pc()  };
-	square sq_1{ mv_1.sq2() }, sq_2{ mv_2.sq2() };
 
-	for (int i{}; i < list.cnt.mv; ++i)
+	const int16* main{ &(*node.hist).main[list.pos.cl][0][0] };
+	const int16* cont1{ &(*node.hist).continuation[mv_1.pc()][mv_1.sq2()][0][0][0] };
+	const int16* cont2{ &(*node.hist).continuation[mv_2.pc()][mv_2.sq2()][0][0][0] };
+
+	__m256i sq_mask { _mm256_set1_epi32(63) };
+	__m256i pc_mask { _mm256_set1_epi32(7) };
+	__m256i cont1_on{ _mm256_set1_epi32(mv_1 ? -1 : 0) };
+	__m256i cont2_on{ _mm256_set1_epi32(mv_2 ? -1 : 0) };
+	__m256i base    { _mm256_set1_epi32(int(history::max * 4)) };
+
+	for (; i + 8 <= list.cnt.mv; i += 8)
+	{
+		__m256i mv { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&list.mv[i])) };
+		__m256i sq1{ _mm256_and_si256(mv, sq_mask) };
+		__m256i sq2{ _mm256_and_si256(_mm256_srli_epi32(mv, 6), sq_mask) };
+		__m256i pc { _mm256_and_si256(_mm256_srli_epi32(mv, 12), pc_mask) };
+
+		// main history is indexed by [sq1][sq2], continuation history by [pc][sq2] with 2 entries each
+		// the 16-bit entries are gathered as 32-bit words and sign-extended, both continuation entries come in one word
+		// the main gather reads 2 bytes beyond the entry, which stays within the table because sq1 & sq2 always differ
+
+		__m256i idx_main{ _mm256_or_si256(_mm256_slli_epi32(sq1, 6), sq2) };
+		__m256i idx_cont{ _mm256_or_si256(_mm256_slli_epi32(pc, 6), sq2) };
+
+		__m256i hist_main{ _mm256_i32gather_epi32(reinterpret_cast<const int*>(main), idx_main, 2) };
+		__m256i hist_cont1{ _mm256_i32gather_epi32(reinterpret_cast<const int*>(cont1), idx_cont, 4) };
+		__m256i hist_cont2{ _mm256_i32gather_epi32(reinterpret_cast<const int*>(cont2), idx_cont, 4) };
+
+		__m256i sc{ _mm256_add_epi32(base, _mm256_srai_epi32(_mm256_slli_epi32(hist_main, 16), 16)) };
+		sc = _mm256_add_epi32(sc, _mm256_and_si256(cont1_on, _mm256_srai_epi32(_mm256_slli_epi32(hist_cont1, 16), 16)));
+		sc = _mm256_add_epi32(sc, _mm256_and_si256(cont2_on, _mm256_srai_epi32(hist_cont2, 16)));
+
+		std::array<uint32, 8> weights{};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(weights.data()), sc);
+
+		for (int j{}; j < 8; ++j)
+		{
+			verify(list.mv[i + j].quiet());
+			verify(list.pos.cl == list.mv[i + j].cl());
+			verify(weights[j] == quiet_hist(list.mv[i + j]));
+
+			if (previous(list.mv[i + j]))
+			{
+				assign(i + j, 0);
+				list.cnt.duplicate += 1;
+			}
+			else
+				assign(i + j, weights[j]);
+		}
+	}
+#endif
+
+	// weighting the remaining moves one by one
+
+	for (; i < list.cnt.mv; ++i)
 	{
 		verify(list.mv[i].quiet());
+		verify(list.pos.cl == list.mv[i].cl());
+
 		if (previous(list.mv[i]))
 		{
-			sc[i] = 0;
+			assign(i, 0);
 			list.cnt.duplicate += 1;
 		}
 		else
-		{
-			piece  pc { list.mv[i].pc()  };
-			square sq1{ list.mv[i].sq1() };
-			square sq { list.mv[i].sq2() };
-			sc[i]  = history::max * 4;
-			sc[i] += (*node.hist).main[list.pos.cl][sq1][sq];
-			sc[i] += mv_1 ? (*node.hist).continuation[pc_1][sq_1][pc][sq][0] : 0;
-			sc[i] += mv_2 ? (*node.hist).continuation[pc_2][sq_2][pc][sq][1] : 0;
-
-			verify(list.pos.cl == list.mv[i].cl());
-		}
+			assign(i, quiet_hist(list.mv[i]));
+	}
+}
+
+template int sort<mode::LEGAL>::partial_sort(uint32);
+template int sort<mode::PSEUDOLEGAL>::partial_sort(uint32);
+template<mode md> int sort<md>::partial_sort(uint32 limit)
+{
+	// sorting all entries weighted at least as high as the limit to the front of the list in descending order
+	// the remaining entries are left unsorted, because most of them will be pruned anyway
+
+	uint64 min_entry{ uint64(limit) << 32 };
+	int sorted{};
+
+	for (int i{}; i < list.cnt.mv; ++i)
+	{
+		if (entry[i] < min_entry)
+			continue;
+
+		uint64 new_entry{ entry[i] };
+		entry[i] = entry[sorted];
+
+		int j{ sorted++ };
+		for (; j > 0 && entry[j - 1] < new_entry; --j)
+			entry[j] = entry[j - 1];
+		entry[j] = new_entry;
 	}
+	return sorted;
 }
 
 template void sort<mode::LEGAL>::loosing();
@@ -254,8 +366,10 @@ template<mode md> void sort<md>::loosing()
 	{
 		verify(list.mv[i].capture() && !list.mv[i].promo());
 		verify(list.mv[i] != node.hash);
-		sc[i] = history::max * 2
-			+ (*node.hist).capture[list.pos.cl][list.mv[i].pc()][list.mv[i].sq2()][list.mv[i].vc()];
+		see[i] = see[lim::moves - 1 - i];
+		verify(see[i] < 0);
+		assign(i, history::max * 2
+			+ (*node.hist).capture[list.pos.cl][list.mv[i].pc()][list.mv[i].sq2()][list.mv[i].vc()]);
 	}
 }
 
@@ -271,7 +385,7 @@ template<mode md> void sort<md>::tactical()
 	for (int i{}; i < list.cnt.capture; ++i)
 	{
 		verify(list.mv[i].capture());
-		sc[i] = mvv_lva(list.mv[i]);
+		assign(i, mvv_lva(list.mv[i]));
 	}
 
 	// promotions with MVV-LVA
@@ -279,7 +393,7 @@ template<mode md> void sort<md>::tactical()
 	for (int i{ list.cnt.capture }; i < list.cnt.capture + list.cnt.promo; ++i)
 	{
 		verify(list.mv[i].promo());
-		sc[i] = mvv_lva_promo(list.mv[i]);
+		assign(i, mvv_lva_promo(list.mv[i]));
 	}
 }
 
@@ -292,6 +406,6 @@ template<mode md> void sort<md>::evasion()
 	for (int i{}; i < list.cnt.mv; ++i)
 	{
 		verify(list.mv[i].quiet());
-		sc[i] = 1;
+		assign(i, 1);
 	}
 }
\ No newline at end of file
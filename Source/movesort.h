@@ -69,9 +69,20 @@ private:
 	gen<md>& list;
 
 public:
-	// storing the assigned weights
+	// storing the moves packed together with their assigned weights
+	// the weight occupies the upper 32 bits, the inverted list index and the move the lower 32 bits,
+	// so the highest entry belongs to the highest weighted move, or to the first one in the list if weights are equal
 
-	std::array<uint32, lim::moves> sc{};
+	std::array<uint64, lim::moves> entry{};
+
+	static move entry_mv(uint64 entry)  { return move{ uint32(entry) & 0x3fffff }; }
+	static int  entry_idx(uint64 entry) { return int(lim::moves) - 1 - int((entry >> 22) & 0xff); }
+	static bool weighted(uint64 entry)  { return entry >> 32; }
+
+	// storing the exact SEE of all captures calculated during the weighting, so that the search can reuse it
+	// all scores fit into 16 bits, which keeps the move-picker of every ply smaller
+
+	std::array<int16, lim::moves> see{};
 
 	// parameters only used in the main alpha-beta move weighting
 
@@ -87,11 +98,18 @@ public:
 	score see_margin{ score::NONE };
 
 private:
+	// packing the weight of the move at index i into its entry
+
+	void assign(int i, uint32 sc);
+
 	// weighting captures & promotions
 
 	uint32 mvv_lva(move mv) const;
 	uint32 mvv_lva_promo(move mv) const;
 
+	// weighting quiet moves
+
+	uint32 quiet_hist(move mv) const;
 	bool previous(move mv) const;
 
 public:
@@ -106,6 +124,10 @@ public:
 	void quiet();
 	void loosing();
 
+	// sorting the best entries in advance
+
+	int partial_sort(uint32 limit);
+
 	// quiescence search
 
 	sort(gen<md> &mvlist) : list{ mvlist } {}
@@ -0,0 +1,336 @@
+/*
+  Monolith Copyright (C) 2017-2026 Jonas Mayr
+
+  Monolith is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Monolith is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Monolith. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "main.h"
+#include "types.h"
+#include "misc.h"
+#include "bit.h"
+#include "board.h"
+#include "nnue.h"
+
+namespace
+{
+	// layout of the network file: a header of 16 bytes followed by the quantized weights
+	// the weights are stored in little-endian order and used directly from the memory-mapped file
+
+	struct header
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 hidden;
+		int32  out_bias;
+	};
+
+	constexpr uint32 magic{ 0x45554e4d };
+	constexpr uint32 version{ 1 };
+	constexpr std::size_t file_size
+	{ sizeof(header) + sizeof(int16) * (nnue::features * nnue::hidden + nnue::hidden + 2 * nnue::hidden) };
+
+	// quantization of the hidden layer (qa) and of the output weights (qb)
+	// the output is scaled to centipawns
+
+	constexpr int qa{ 255 };
+	constexpr int qb{ 64 };
+	constexpr int scale{ 400 };
+
+	struct network
+	{
+		const int16* ft_weight{};
+		const int16* ft_bias{};
+		const int16* out_weight{};
+		int32 out_bias{};
+	} net{};
+
+	void* mapped_data{};
+	memorymap mapping{};
+	std::vector<int16> random_weights{};
+}
+
+namespace feature
+{
+	// assisting functions to keep the accumulator up to date
+	// the features of the black perspective are mirrored vertically & have the colors swapped
+
+	template<color persp>
+	static int index(color cl, piece pc, square sq)
+	{
+		return ((cl != persp) * 6 + pc) * 64 + (persp == WHITE ? sq : sq ^ 56);
+	}
+
+	static void add(std::array<int16, nnue::hidden>& v, int idx)
+	{
+		const int16* w{ net.ft_weight + idx * nnue::hidden };
+		for (int i{}; i < nnue::hidden; ++i)
+			v[i] += w[i];
+	}
+
+	static void sub(std::array<int16, nnue::hidden>& v, int idx)
+	{
+		const int16* w{ net.ft_weight + idx * nnue::hidden };
+		for (int i{}; i < nnue::hidden; ++i)
+			v[i] -= w[i];
+	}
+
+	static void update(const nnue::accumulator& prev, nnue::accumulator& acc)
+	{
+		// bringing the accumulator up to date by comparing the piece placement with the previous accumulator
+		// only the 2 to 4 squares that have changed through the move have to be updated
+
+		acc.v = prev.v;
+		for (color cl : { WHITE, BLACK })
+		{
+			for (piece pc : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING })
+			{
+				bit64 pc_old{ prev.pieces[pc] & prev.side[cl] };
+				bit64 pc_new{  acc.pieces[pc] &  acc.side[cl] };
+				for (bit64 added{ pc_new & ~pc_old }; added; added &= added - 1)
+				{
+					square sq{ bit::scan(added) };
+					add(acc.v[WHITE], index<WHITE>(cl, pc, sq));
+					add(acc.v[BLACK], index<BLACK>(cl, pc, sq));
+				}
+				for (bit64 removed{ pc_old & ~pc_new }; removed; removed &= removed - 1)
+				{
+					square sq{ bit::scan(removed) };
+					sub(acc.v[WHITE], index<WHITE>(cl, pc, sq));
+					sub(acc.v[BLACK], index<BLACK>(cl, pc, sq));
+				}
+			}
+		}
+		acc.computed = true;
+	}
+}
+
+namespace infer
+{
+	// inference kernels of the output layer, all of them have to produce exactly the same sum
+
+	static int32 scalar(const int16* us, const int16* them)
+	{
+		int32 sum{};
+		for (int i{}; i < nnue::hidden; ++i)
+		{
+			sum += std::clamp(int32(us[i]),   0, qa) * net.out_weight[i];
+			sum += std::clamp(int32(them[i]), 0, qa) * net.out_weight[nnue::hidden + i];
+		}
+		return sum;
+	}
+
+#if defined(__SSE2__)
+
+	static int32 sse2(const int16* us, const int16* them)
+	{
+		const __m128i zero{ _mm_setzero_si128() };
+		const __m128i ceil{ _mm_set1_epi16(qa) };
+		__m128i sum{ zero };
+		for (int i{}; i < nnue::hidden; i += 8)
+		{
+			__m128i v_us  { _mm_loadu_si128(reinterpret_cast<const __m128i*>(us   + i)) };
+			__m128i v_them{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(them + i)) };
+			__m128i w_us  { _mm_loadu_si128(reinterpret_cast<const __m128i*>(net.out_weight + i)) };
+			__m128i w_them{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(net.out_weight + nnue::hidden + i)) };
+			v_us   = _mm_min_epi16(_mm_max_epi16(v_us,   zero), ceil);
+			v_them = _mm_min_epi16(_mm_max_epi16(v_them, zero), ceil);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(v_us,   w_us));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(v_them, w_them));
+		}
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+		return _mm_cvtsi128_si32(sum);
+	}
+
+#endif
+#if defined(__AVX2__)
+
+	static int32 avx2(const int16* us, const int16* them)
+	{
+		const __m256i zero{ _mm256_setzero_si256() };
+		const __m256i ceil{ _mm256_set1_epi16(qa) };
+		__m256i sum{ zero };
+		for (int i{}; i < nnue::hidden; i += 16)
+		{
+			__m256i v_us  { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(us   + i)) };
+			__m256i v_them{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(them + i)) };
+			__m256i w_us  { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(net.out_weight + i)) };
+			__m256i w_them{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(net.out_weight + nnue::hidden + i)) };
+			v_us   = _mm256_min_epi16(_mm256_max_epi16(v_us,   zero), ceil);
+			v_them = _mm256_min_epi16(_mm256_max_epi16(v_them, zero), ceil);
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v_us,   w_us));
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v_them, w_them));
+		}
+		__m128i half{ _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)) };
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+		return _mm_cvtsi128_si32(half);
+	}
+
+#endif
+}
+
+const nnue::kernel nnue::best_kernel
+{
+#if defined(__AVX2__)
+	kernel::AVX2
+#elif defined(__SSE2__)
+	kernel::SSE2
+#else
+	kernel::SCALAR
+#endif
+};
+
+const std::array<const char*, 3> nnue::kernel_name{ { "scalar", "sse2", "avx2" } };
+
+bool nnue::load(const std::string& filename)
+{
+	// mapping the network file into memory & pointing the weights to it
+	// the file is rejected if its size or its header don't match the network architecture
+
+	unload();
+	datafile df{ filesystem::open_file(filename, filesystem::READ) };
+	if (df == FILE_ERROR)
+		return false;
+
+	void* data{ filesystem::size_file(df) == file_size ? memory::map(df, mapping) : nullptr };
+	filesystem::close_file(df);
+	if (!data)
+		return false;
+
+	auto hd{ static_cast<const header*>(data) };
+	if (hd->magic != magic || hd->version != version || hd->hidden != hidden)
+	{
+		memory::unmap(data, mapping);
+		return false;
+	}
+
+	auto weights{ reinterpret_cast<const int16*>(hd + 1) };
+	mapped_data = data;
+	net = network{ weights, weights + features * hidden, weights + features * hidden + hidden, hd->out_bias };
+	return true;
+}
+
+void nnue::load_random()
+{
+	// generating a network with random weights to test the accumulator updates & the inference kernels
+	// the magnitude of the weights resembles that of a trained network
+
+	unload();
+	rand_64 rand_gen{};
+	random_weights.resize(features * hidden + 3 * hidden);
+	for (auto& w : random_weights)
+		w = int16(rand_gen.rand64() % 128) - 64;
+
+	net = network{ random_weights.data(), random_weights.data() + features * hidden,
+		random_weights.data() + features * hidden + hidden, 0 };
+}
+
+void nnue::unload()
+{
+	// falling back to the hand-crafted evaluation
+
+	memory::unmap(mapped_data, mapping);
+	mapped_data = nullptr;
+	random_weights.clear();
+	net = network{};
+}
+
+bool nnue::active()
+{
+	return net.ft_weight != nullptr;
+}
+
+void nnue::refresh(const board& pos, accumulator& acc)
+{
+	// computing the accumulator from scratch
+
+	for (color persp : { WHITE, BLACK })
+		std::copy(net.ft_bias, net.ft_bias + hidden, acc.v[persp].begin());
+
+	for (color cl : { WHITE, BLACK })
+	{
+		for (piece pc : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING })
+		{
+			for (bit64 pieces{ pos.pieces[pc] & pos.side[cl] }; pieces; pieces &= pieces - 1)
+			{
+				square sq{ bit::scan(pieces) };
+				feature::add(acc.v[WHITE], feature::index<WHITE>(cl, pc, sq));
+				feature::add(acc.v[BLACK], feature::index<BLACK>(cl, pc, sq));
+			}
+		}
+	}
+	acc.pieces = pos.pieces;
+	acc.side = { pos.side[WHITE], pos.side[BLACK] };
+	acc.computed = true;
+}
+
+int nnue::output(const accumulator& acc, color cl, kernel kn)
+{
+	// propagating the accumulator of the side to move & of the opponent through the output layer
+
+	const int16* us  { acc.v[cl].data() };
+	const int16* them{ acc.v[cl ^ 1].data() };
+	int32 sum{};
+	switch (kn)
+	{
+#if defined(__AVX2__)
+	case kernel::AVX2: sum = infer::avx2(us, them); break;
+#endif
+#if defined(__SSE2__)
+	case kernel::SSE2: sum = infer::sse2(us, them); break;
+#endif
+	default: sum = infer::scalar(us, them);
+	}
+	return int((int64(sum) + net.out_bias) * scale / (qa * qb));
+}
+
+score nnue::static_eval(const board& pos)
+{
+	// evaluating the position from the point of view of the side to move
+	// positions outside of the search have no accumulator stack & are evaluated from scratch
+
+	int sc{};
+	if (!pos.acc)
+	{
+		accumulator acc;
+		refresh(pos, acc);
+		sc = output(acc, pos.cl);
+	}
+	else
+	{
+		// walking back to the last computed accumulator & updating all accumulators from there on
+		// the accumulator of the root is always computed
+
+		accumulator* acc{ pos.acc };
+		while (!acc->computed)
+			acc -= 1;
+		for (; acc != pos.acc; acc += 1)
+			feature::update(*acc, *(acc + 1));
+
+		verify([&]{ accumulator ref; refresh(pos, ref); return ref.v == pos.acc->v; }());
+		sc = output(*pos.acc, pos.cl);
+	}
+	return score(std::clamp(sc, TB_LOSS + 1, TB_WIN - 1));
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+/*
+  Monolith Copyright (C) 2017-2026 Jonas Mayr
+
+  Monolith is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Monolith is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Monolith. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "board.h"
+#include "types.h"
+
+// evaluating positions with an efficiently updatable neural network as an alternative to the hand-crafted evaluation
+// the network is a simple perceptron 768 -> 2x256 -> 1 with a clipped ReLU activation of the hidden layer
+
+namespace nnue
+{
+	constexpr int features{ 768 };
+	constexpr int hidden{ 256 };
+
+	// the hidden layer is kept as an accumulator of the active features of both perspectives
+	// every ply of the search gets its own accumulator, which is only brought up to date if the position is evaluated
+
+	struct accumulator
+	{
+		alignas(64) std::array<std::array<int16, hidden>, 2> v;
+		std::array<bit64, 6> pieces;
+		std::array<bit64, 2> side;
+		bool computed;
+	};
+
+	// inference kernels of the output layer, the best one available is selected at build time
+
+	enum class kernel { SCALAR, SSE2, AVX2 };
+	extern const kernel best_kernel;
+	extern const std::array<const char*, 3> kernel_name;
+
+	// managing the network, the weights are memory-mapped from the file
+
+	bool load(const std::string& filename);
+	void load_random();
+	void unload();
+	bool active();
+
+	// evaluating the position
+
+	void refresh(const board& pos, accumulator& acc);
+	int output(const accumulator& acc, color cl, kernel kn = best_kernel);
+	score static_eval(const board& pos);
+
+	// advancing the accumulator pointer of the board after a move has been made
+	// saving the piece placement allows for a lazy update of the accumulator later on
+
+	inline void push(board& pos)
+	{
+		pos.acc += 1;
+		pos.acc->computed = false;
+		pos.acc->pieces = pos.pieces;
+		pos.acc->side = { pos.side[WHITE], pos.side[BLACK] };
+	}
+}
\ No newline at end of file
@@ -35,6 +35,7 @@
 #include "move.h"
 #include "trans.h"
 #include "eval.h"
+#include "nnue.h"
 #include "uci.h"
 #include "thread.h"
 #include "board.h"
@@ -78,7 +79,7 @@ namespace null
 		stack->mv = move{};
 		stack->cont_mv = &thread.hist.corr_cont[0][NO_SQUARE];
 		stack->null_mv = sstack::null_move{};
-		pos.null_move(stack->null_mv.ep, stack->null_mv.sq);
+		pos.null_move(stack->null_mv.ep, stack->null_mv.sq, stack->null_mv.cnt);
 		(stack + 1)->pruning = false;
 	}
 
@@ -86,34 +87,112 @@ namespace null
 	{
 		// reverting the "null move"
 
-		pos.revert_null_move(stack->null_mv.ep, stack->null_mv.sq);
+		pos.revert_null_move(stack->null_mv.ep, stack->null_mv.sq, stack->null_mv.cnt);
 		(stack + 1)->pruning = true;
 	}
 }
 
+namespace lookup
+{
+	static void prefetch(sthread& thread, const board::key_pos& key, color cl, move mv, const sstack* stack)
+	{
+		// pre-loading the table entries of the next position as soon as its hash keys are known
+		// the transposition table, the pawn-structure table & the correction history tables are covered
+
+		memory::prefetch((char*)trans::get_entry(key.pos));
+		thread.hash.prefetch_pawn(key.pawn);
+		thread.hist.prefetch_corr(key, cl, mv, stack);
+	}
+}
+
 namespace p_variation
 {
-	static void update_root(move mv, move_var& pv, const search::node::p_variation* pv_next, key64& key)
+	// the provisional PV of every ply is kept in a row of the triangular PV-table of the thread
+	// the row of a node is built from the move that raised alpha & the row of the next ply
+
+	static void update_root(move mv, move_var& pv, const move_line& pv_next, key64& key)
 	{
 		// updating the whole PV if a new best root move has been found
 
 		pv.pos_key = key;
-		pv.cnt = 1 + pv_next->cnt;
+		pv.cnt = 1 + pv_next.cnt;
 		pv.mv[0] = mv;
-		int pv_max{ std::min(pv_next->cnt, lim::dt - 1) };
-		for (int i{}; i < pv_max; ++i)
-			pv.mv[i + 1] = pv_next->mv[i];
+		int pv_max{ std::min(pv_next.cnt, lim::dt - 1) };
+		std::copy_n(pv_next.mv.begin(), pv_max, pv.mv.begin() + 1);
 	}
 
-	static void update_leaf(move mv, search::node::p_variation* pv, const search::node::p_variation* pv_next)
+	static void update_leaf(move mv, move_line& pv, const move_line& pv_next)
 	{
 		// updating the provisional PV during the search
 
-		pv->cnt = 1 + pv_next->cnt;
-		pv->mv[0] = mv;
-		int pv_max{ std::min(pv_next->cnt, lim::dt - 1) };
-		for (int i{}; i < pv_max; ++i)
-			pv->mv[i + 1] = pv_next->mv[i];
+		pv.cnt = 1 + pv_next.cnt;
+		pv.mv[0] = mv;
+		int pv_max{ std::min(pv_next.cnt, lim::dt - 1) };
+		std::copy_n(pv_next.mv.begin(), pv_max, pv.mv.begin() + 1);
+	}
+}
+
+namespace warm
+{
+	// resuming the analysis of the previous search if the same position or a position further down its PV is searched
+	// only analysis & ponder searches are resumed, regular game searches always start from scratch
+
+	static std::vector<key64> reversible(const std::vector<key64>& game_hash, int half_cnt)
+	{
+		// the positions since the last capture or pawn move, which are the only ones that can still be repeated
+
+		auto cnt{ std::min(std::size_t(half_cnt) + 1, game_hash.size()) };
+		return { game_hash.end() - cnt, game_hash.end() };
+	}
+
+	static depth start(sthread& thread, const board& pos, rootpick& pick)
+	{
+		// returning the depth at which iterative deepening can start
+		// mate scores are not resumed, because they depend on the distance to the root
+
+		auto& prior{ thread.prior };
+		if (!uci::infinite || !prior.dt || pick.tb_pos || !uci::limit.searchmoves.empty())
+			return 1;
+		if (std::any_of(prior.pv.begin(), prior.pv.end(), [](const move_var& pv) { return sc::mate(pv.sc) || sc::tb::mate(pv.sc); }))
+			return 1;
+
+		// the same position gets the root node statistics & all PVs of the previous search
+		// the game history has to match as well, because repetitions change the outcome of the search
+
+		auto history{ reversible(uci::game_hash, pos.half_cnt) };
+		if (prior.pos.key.pos == pos.key.pos)
+		{
+			if (prior.pv.size() != uci::multipv || reversible(prior.game_hash, prior.pos.half_cnt) != history)
+				return 1;
+			pick.restore(prior.root);
+			thread.pv = prior.pv;
+			return std::min(prior.dt, uci::limit.dt);
+		}
+
+		// a position reached by playing 1 or 2 moves of the PV gets the remaining PV
+		// usually the best move has been played on the analysis board, or followed by the expected reply when pondering
+
+		auto& prior_pv{ prior.pv.front() };
+		if (uci::multipv != 1)
+			return 1;
+
+		board prior_pos{ prior.pos };
+		std::vector<key64> prior_hash{ prior.game_hash };
+		for (int ply{ 1 }; ply <= 2 && ply < prior_pv.cnt; ++ply)
+		{
+			prior_pos.new_move(prior_pv.mv[ply - 1]);
+			prior_hash.push_back(prior_pos.key.pos);
+			if (prior_pos.key.pos != pos.key.pos || reversible(prior_hash, prior_pos.half_cnt) != history)
+				continue;
+
+			auto& pv{ thread.pv.front() };
+			pv.pos_key = pos.key.pos;
+			pv.cnt = prior_pv.cnt - ply;
+			pv.sc = ply & 1 ? -prior_pv.sc : prior_pv.sc;
+			std::copy_n(prior_pv.mv.begin() + ply, pv.cnt, pv.mv.begin());
+			return std::clamp(prior.dt - ply, 1, uci::limit.dt);
+		}
+		return 1;
 	}
 }
 
@@ -157,7 +236,7 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 	verify(dt <= 0);
 	thread.cnt_n += 1;
 	thread.seldt = std::max(thread.seldt, stack->dt);
-	nd.p_var->cnt = 0;
+	thread.pv_table[stack->dt].cnt = 0;
 
 	board& pos{ *nd.pos };
 	thread.check_expiration();
@@ -166,22 +245,37 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 	
 	if (pos.draw(thread.rep_hash, uci::mv_offset + stack->dt))
 		return DRAW;
+
+	// raising alpha to a draw if the side to move can force a repetition (? Elo)
+
+	if (alpha < DRAW && pos.cycle(thread.rep_hash, uci::mv_offset + stack->dt, stack->dt))
+	{
+		alpha = DRAW;
+		if (alpha >= beta)
+			return alpha;
+	}
 	
 	if (sc::mate_distance_pruning(alpha, beta, stack->dt))
 		return alpha;
 
 	// looking for a cutoff through the transposition table (~20 Elo)
+	// plies beyond the maximal search depth are not hashed
+	// nodes in check only trust entries of the main search, because deeper quiescence nodes don't know about checks
 	
 	trans::entry tt{};
-	if (dt == 0 && tt.probe(pos.key.pos, stack->dt) && sc::tt_cutoff(tt.bd, tt.sc, alpha, beta))
+	bool hashing{ stack->dt <= lim::dt };
+	if (hashing && tt.probe(pos.key.pos, stack->dt) && (!nd.check || tt.dt > 0) && sc::tt_cutoff(tt.bd, tt.sc, alpha, beta))
 		return tt.sc;
 
 	// evaluating the position with the static evaluation
+	// the evaluation is allowed to exit lazily if the score is far outside of the window
 	// the evaluation is then corrected with history tables (~75 Elo)
 
-	score stand_pat{ eval::static_eval(pos, thread.hash) };
+	score stand_pat{ eval::static_eval(pos, thread.hash, score(alpha - LAZY_MARGIN), score(beta + LAZY_MARGIN)) };
 	stand_pat = thread.hist.correct_sc(pos, stack, stand_pat);
 	score best_sc{ stand_pat };
+	score old_alpha{ alpha };
+	move  best_mv{};
 
 	if (!nd.check && stand_pat > alpha)
 	{
@@ -194,7 +288,6 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 
 	// generating and sorting moves while looping through them
 
-	node::p_variation new_pv{};
 	movepick<mode::LEGAL> pick(pos, nd.check);
 	for (move mv{ pick.next() }; mv; mv = pick.next())
 	{
@@ -218,12 +311,13 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 				continue;
 		}
 
+		lookup::prefetch(thread, zobrist::next_keys(pos, mv), pos.cl_x, mv, stack + 1);
 		pos.new_move(mv);
 		verify(pos.legal());
 
 		stack->mv = mv;
 		stack->cont_mv = &thread.hist.corr_cont[mv.pc()][mv.sq2()];
-		node new_nd{ &pos, &new_pv, false, false, false };
+		node new_nd{ &pos, false, false, false };
 
 		score sc{ -qsearch(thread, stack + 1, new_nd, dt - 1, -beta, -alpha) };
 		pos = pick.list.pos;
@@ -235,9 +329,10 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 			if (sc > alpha)
 			{
 				alpha = sc;
+				best_mv = mv;
 				if (sc >= beta)
-					return sc;
-				p_variation::update_leaf(mv, nd.p_var, &new_pv);
+					break;
+				p_variation::update_leaf(mv, thread.pv_table[stack->dt], thread.pv_table[stack->dt + 1]);
 			}
 		}
 	}
@@ -247,6 +342,12 @@ score search::qsearch(sthread& thread, sstack* stack, node nd, depth dt, score a
 	
 	if (nd.check && pick.hits == 0)
 		return score(stack->dt) - MATE;
+
+	// storing the result in the transposition table at depth 0, which is reserved for the quiescence search
+	// entries of the main search are kept together with their hash move
+
+	if (hashing && tt.dt == 0)
+		trans::store(pos.key.pos, best_mv, sc::make_bounded(best_sc, old_alpha, beta), 0, stack->dt);
 	
 	verify(type::sc(best_sc));
 	return best_sc;
@@ -268,7 +369,7 @@ namespace search
 			return qsearch(thread, stack, nd, 0, alpha, beta);
 
 		thread.cnt_n += 1;
-		nd.p_var->cnt = 0;
+		thread.pv_table[stack->dt].cnt = 0;
 		nd.pv = (beta != alpha + 1);
 		board& pos{ *nd.pos };
 		thread.check_expiration();
@@ -278,6 +379,15 @@ namespace search
 		if (pos.draw(thread.rep_hash, uci::mv_offset + stack->dt))
 			return DRAW;
 
+		// raising alpha to a draw if the side to move can force a repetition with an upcoming move (? Elo)
+
+		if (alpha < DRAW && pos.cycle(thread.rep_hash, uci::mv_offset + stack->dt, stack->dt))
+		{
+			alpha = DRAW;
+			if (alpha >= beta)
+				return alpha;
+		}
+
 		if (sc::mate_distance_pruning(alpha, beta, stack->dt))
 			return alpha;
 
@@ -291,18 +401,24 @@ namespace search
 			if ((tt.sc <= alpha || tt.sc >= beta) && sc::tt_cutoff(tt.bd, tt.sc, alpha, beta))
 				return tt.sc;
 
-		// probing Syzygy endgame table-bases
+		// probing Syzygy endgame table-bases & the built-in bitbases
+
+		auto tb_sc{ thread.probe_syzygy(pos, dt, stack->dt) };
+		if (std::get<0>(tb_sc) == score::NONE)
+			tb_sc = thread.probe_bitbase(pos, stack->dt);
 
-		if (auto sc{ thread.probe_syzygy(pos, dt, stack->dt) }; std::get<0>(sc) != score::NONE)
+		if (std::get<0>(tb_sc) != score::NONE)
 		{
-			trans::store(key, move{}, sc, lim::dt - 1, stack->dt);
-			return std::get<0>(sc);
+			trans::store(key, move{}, tb_sc, lim::dt - 1, stack->dt);
+			return std::get<0>(tb_sc);
 		}
 
 		// evaluating the current position, correcting the static eval with history tables (~20 Elo)
 
-		node::p_variation new_pv{};
-		score sc{ nd.check ? score::NONE : eval::static_eval(pos, thread.hash)};
+		// the attack tables of the evaluation are kept for the move-picker
+
+		stack->att = {};
+		score sc{ nd.check ? score::NONE : eval::static_eval(pos, thread.hash, stack->att) };
 		stack->sc = sc = thread.hist.correct_sc(pos, stack, sc);
 		(stack + 1)->killer = {};
 		(stack + 2)->fail_high_cnt = 0;
@@ -336,8 +452,9 @@ namespace search
 		if (pruning && dt >= NMP_DT && !stack->singular_mv && !pos.lone_pawns() && sc >= beta)
 		{
 			depth red{ NMP_RED1 + dt / NMP_RED2 + std::min(3, depth(sc - beta) / NMP_RED3) };
+			lookup::prefetch(thread, zobrist::next_keys(pos, move{}), pos.cl_x, move{}, stack + 1);
 			null::make_move(pos, stack, thread);
-			node  new_nd{ &pos, &new_pv, false, !nd.cut, false };
+			node  new_nd{ &pos, false, !nd.cut, false };
 			score null_sc{ -alphabeta(thread, stack + 1, new_nd, dt - red, -beta, score(1) - beta) };
 			null::revert_move(pos, stack);
 
@@ -350,7 +467,7 @@ namespace search
 		if (stack->pruning && nd.pv && !tt.mv && dt >= IID_DT)
 		{
 			stack->pruning = false;
-			node new_nd{ &pos, &new_pv, nd.check, nd.cut, false };
+			node new_nd{ &pos, nd.check, nd.cut, false };
 			alphabeta(thread, stack, new_nd, dt - IID_RED, alpha, beta);
 			stack->pruning = true;
 			tt.probe(key, stack->dt);
@@ -394,14 +511,22 @@ namespace search
 			if (pruning && quiet && !gives_check && !nd.check)
 			{
 				// late move pruning (~50 Elo)
+				// both pruning conditions stay true for the rest of the node, so the move-picker
+				// can skip all remaining quiet moves that don't give check
 
 				if (dt <= LMP_DT && pick.hits >= late_move_cnt[critical][dt])
+				{
+					pick.skip_quiets();
 					continue;
+				}
 
 				// futility pruning (~15 Elo)
 
 				if (dt <= FUT_DT && stack->sc + FUT_MARGIN1 + FUT_MARGIN2 * dt <= alpha)
+				{
+					pick.skip_quiets();
 					continue;
+				}
 
 				// continuation-history pruning (~2 Elo)
 
@@ -410,7 +535,7 @@ namespace search
 
 				// SEE pruning quiets (~5 Elo)
 
-				if (dt <= SEE_QUIET_DT && !attack::see_above(pos, mv, score(SEE_QUIET_MARGIN * dt)))
+				if (dt <= SEE_QUIET_DT && !pick.see_above(mv, score(SEE_QUIET_MARGIN * dt)))
 					continue;
 			}
 
@@ -421,7 +546,7 @@ namespace search
 
 			// SEE pruning bad tactical moves (~10 Elo)
 
-			if (pruning && !quiet && dt <= SEE_TAC_DT && !attack::see_above(pos, mv, score(SEE_TAC_MARGIN * dt)))
+			if (pruning && !quiet && dt <= SEE_TAC_DT && !pick.see_above(mv, score(SEE_TAC_MARGIN * dt)))
 				continue;
 
 			// singular extension (~2 Elo)
@@ -434,7 +559,7 @@ namespace search
 
 				score alpha_bd{ std::max(tt.sc - score(dt), -MATE) };
 				stack->singular_mv = mv;
-				node new_nd{ &pos, &new_pv, nd.check, nd.cut, false };
+				node new_nd{ &pos, nd.check, nd.cut, false };
 				sc = -alphabeta(thread, stack, new_nd, dt - SE_RED, alpha_bd, alpha_bd + score(1));
 
 				verify(stack->singular_mv == mv);
@@ -450,10 +575,9 @@ namespace search
 			if (gives_check || (mv == tt.mv && dt >= HIST_EXT_DT && hist.all() >= HIST_EXT_MARGIN && std::abs(tt.sc) <= 500))
 				ext = 1;
 
-			// speculative prefetch of the next TT-entry (~15 Elo)
+			// speculative prefetch of the table entries of the next position (~15 Elo)
 
-			key64 next_key{ zobrist::pos_key(pos, mv) };
-			memory::prefetch((char*)trans::get_entry(next_key));
+			lookup::prefetch(thread, zobrist::next_keys(pos, mv), pos.cl_x, mv, stack + 1);
 
 			// doing the move and checking if it is legal
 
@@ -465,11 +589,16 @@ namespace search
 			}
 			stack->mv = mv;
 			stack->cont_mv = &thread.hist.corr_cont[mv.pc()][mv.sq2()];
+
+			// remembering the tried moves for the history malus
+			// if the list is full, the last entry is overwritten, so that the current move is always the last one
+
 			if (quiet)
-				stack->quiet_mv[quiet_cnt++] = mv;
+				stack->quiet_mv[quiet_cnt < lim::tried_quiets ? quiet_cnt++ : quiet_cnt - 1] = mv;
 			else if (mv.capture())
-				stack->capture_mv[capture_cnt++] = mv;
-			node new_nd{ &pos, &new_pv, gives_check, true, false };
+				stack->capture_mv[capture_cnt < lim::tried_captures ? capture_cnt++ : capture_cnt - 1] = mv;
+
+			node new_nd{ &pos, gives_check, true, false };
 			verify(gives_check == pos.check());
 
 			// late move reduction (~180 Elo)
@@ -487,7 +616,7 @@ namespace search
 					red_dt += !nd.pv;
 					red_dt += hist.all() / HIST_RED;
 					red_dt += alpha - stack->sc > ALPHA_MARGIN;
-					red_dt -= !nd.cut && attack::escape(pick.list.pos, mv);
+					red_dt -= !nd.cut && pick.escape(mv);
 					red_dt -= (stack + 1)->fail_high_cnt <= FAIL_HIGH_CNT;
 				}
 				else
@@ -552,7 +681,7 @@ namespace search
 						break;
 					}
 					alpha = sc;
-					p_variation::update_leaf(mv, nd.p_var, &new_pv);
+					p_variation::update_leaf(mv, thread.pv_table[stack->dt], thread.pv_table[stack->dt + 1]);
 				}
 			}
 		}
@@ -592,7 +721,6 @@ namespace search
 		auto stack{ thread.stack_front() };
 		(stack + 1)->killer = {};
 		(stack + 2)->fail_high_cnt = 0;
-		node::p_variation pv{};
 		score sc{ score::NONE };
 		int mv_n{};
 
@@ -609,7 +737,7 @@ namespace search
 
 			pos.new_move(root->mv);
 			verify(pos.legal());
-			node new_nd{ &pos, &pv, root->check, mv_n > 1, false };
+			node new_nd{ &pos, root->check, mv_n > 1, false };
 			stack->mv = root->mv;
 			stack->cont_mv = &thread.hist.corr_cont[root->mv.pc()][root->mv.sq2()];
 
@@ -648,7 +776,7 @@ namespace search
 				// adding a bonus to favor the move in the next rearrangement of the move order (~0 Elo)
 
 				alpha = sc;
-				p_variation::update_root(root->mv, thread.pv[multipv], &pv, pos.key.pos);
+				p_variation::update_root(root->mv, thread.pv[multipv], thread.pv_table[stack->dt + 1], pos.key.pos);
 				if (pick.tb_pos)
 					thread.pv[multipv].tb_root = refinable;
 
@@ -722,6 +850,15 @@ namespace search
 		// starting by generating all root node moves
 
 		board pos{ thread.pos };
+		if (nnue::active())
+		{
+			// setting up the accumulator stack of the neural network evaluation, starting with the root
+
+			thread.acc.resize(thread.stack.size());
+			pos.acc = thread.acc.data();
+			nnue::refresh(pos, *pos.acc);
+		}
+
 		rootpick pick(pos);
 		thread.cnt_root_mv = pick.mv_cnt();
 
@@ -731,9 +868,11 @@ namespace search
 		thread.cnt_tbhit += pick.tb_pos;
 
 		// starting iterative deepening & looping through all principal variations indicated by UCI command 'MultiPV'
+		// the analysis of a position that has been searched before resumes where the previous search stopped
 
 		score sc{ score::NONE };
-		for (depth dt{ 1 }; dt <= uci::limit.dt && !uci::stop; ++dt)
+		depth start{ warm::start(thread, pos, pick) }, completed{ start - 1 };
+		for (depth dt{ start }; dt <= uci::limit.dt && !uci::stop; ++dt)
 		{
 			for (int i{}; i < (int)uci::multipv && i < pick.mv_cnt() && !uci::stop; ++i)
 			{
@@ -758,6 +897,8 @@ namespace search
 				if (sc != -MATE)
 					pv.sc = sc;
 			}
+			if (!uci::stop)
+				completed = dt;
 
 			// providing search information at every iteration & checking the search expiration conditions
 
@@ -766,6 +907,11 @@ namespace search
 			if (abort(thread.chrono, thread.pv[0].mv, pick, dt, thread.pv[0].sc))
 				break;
 		}
+
+		// keeping the outcome of the search for the next analysis
+
+		thread.prior = sthread::prior_search{ thread.pos, uci::game_hash, completed, thread.pv, {} };
+		pick.save(thread.prior.root);
 	}
 }
 
@@ -43,7 +43,6 @@ namespace search
     struct node
     {
         board* pos;
-        struct p_variation{ std::array<move, lim::dt> mv; int cnt; }* p_var;
         bool check;
         bool cut;
         bool pv;
@@ -86,6 +85,7 @@ namespace search
     // tunable search parameters
 
     SPSA(DELTA_MARGIN, 100, 0, 150, 10);
+    SPSA(LAZY_MARGIN, 400, 100, 800, 50);
     SPSA(IIR_DT, 5, 4, 9, 1);
     SPSA(SNMP_DT, 7, 3, 8, 1);
     SPSA(SNMP_MARGIN1, 26, 10, 80, 5);
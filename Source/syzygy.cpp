@@ -1127,7 +1127,7 @@ namespace syzygy
 
 		// obtaining the position's material-signature key
 
-		key64 key{ zobrist::mat_key<board>(pos, false) };
+		key64 key{ pos.key.mat };
 
 		int hashIdx = key >> (64 - lim::hash_bits);
 		while (tb_hash[hashIdx].key && tb_hash[hashIdx].key != key)
@@ -1632,7 +1632,7 @@ namespace syzygy
 		return best;
 	}
 
-	static bool probe_dtz_root(board& pos, rootpick& pick, const std::array<key64, 256>& rep_hash)
+	static bool probe_dtz_root(board& pos, rootpick& pick, const std::vector<key64>& rep_hash)
 	{
 		// using the Distance-To-Zero tables to weight all root moves
 
@@ -25,6 +25,7 @@
 #include "main.h"
 #include "types.h"
 #include "syzygy.h"
+#include "bitbase.h"
 #include "uci.h"
 #include "move.h"
 #include "board.h"
@@ -69,13 +70,14 @@ void sthread::init()
 {
 	// initializing all parameters at the beginning of each search
 
-	verify(uci::mv_offset < (int)rep_hash.size());
-	verify(uci::mv_offset < (int)uci::game_hash.size());
+	verify(uci::mv_offset + 1 == (int)uci::game_hash.size());
 
 	cnt_n = cnt_tbhit = cnt_root_mv = seldt = 0;
 
-	for (int i{}; i <= uci::mv_offset; ++i)
-		rep_hash[i] = uci::game_hash[i];
+	// the repetition history has to hold the game history and the deepest possible search path
+
+	rep_hash.resize(uci::game_hash.size() + stack.size());
+	std::copy(uci::game_hash.begin(), uci::game_hash.end(), rep_hash.begin());
 
 	for (depth dt{}; dt < (depth)stack.size(); ++dt)
 	{
@@ -169,6 +171,21 @@ std::tuple<score, bound> sthread::probe_syzygy(board& board_pos, depth dt, depth
     return { score::NONE, bound::NONE };
 }
 
+std::tuple<score, bound> sthread::probe_bitbase(const board& board_pos, depth stack_dt) const
+{
+	// probing the built-in bitbases
+	// draws are exact, wins & losses are only returned after a conversion to make sure that the search makes progress
+
+	switch (bitbase::probe(board_pos))
+	{
+	case bitbase::result::DRAW: return { DRAW, bound::EXACT };
+	case bitbase::result::WIN:  if (board_pos.half_cnt == 0) return { TB_WIN  - score(stack_dt), bound::LOWER }; break;
+	case bitbase::result::LOSS: if (board_pos.half_cnt == 0) return { TB_LOSS + score(stack_dt), bound::UPPER }; break;
+	default: break;
+	}
+	return { score::NONE, bound::NONE };
+}
+
 void sthread::extend_time(score drop)
 {
 	// extending the search-time if the score is dropping
@@ -240,6 +257,22 @@ void thread_pool::clear_history()
 		t->hist.clear();
 }
 
+void thread_pool::clear_prior()
+{
+	// forgetting the previous search, the warm start relies on the hash table still holding its results
+
+	for (auto t : thread)
+		t->prior = sthread::prior_search{};
+}
+
+void thread_pool::allocate_eval_hash()
+{
+	// allocating the pawn hash tables of each thread again after their size has changed
+
+	for (auto t : thread)
+		t->hash.allocate();
+}
+
 std::tuple<move, move> thread_pool::get_bestmove() const
 {
 	// looking for the best move of all the search threads at the end of the search
@@ -264,4 +297,17 @@ std::tuple<move, move> thread_pool::get_bestmove() const
 	if (!thread[idx]->main())
 		uci::info_iteration(*thread[idx]);
 	return std::make_tuple(bestmv, ponder);
+}
+
+double thread_pool::get_pawn_hitrate() const
+{
+	// summing up the pawn-structure table hits of all threads
+
+	int64 probes{}, hits{};
+	for (auto& t : thread)
+	{
+		probes += t->hash.cnt_probe;
+		hits   += t->hash.cnt_hit;
+	}
+	return probes ? double(hits) * 100.0 / double(probes) : 0.0;
 }
\ No newline at end of file
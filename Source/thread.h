@@ -27,7 +27,9 @@
 #include <tuple>
 
 #include "history.h"
+#include "movesort.h"
 #include "eval.h"
+#include "nnue.h"
 #include "move.h"
 #include "time.h"
 #include "board.h"
@@ -65,20 +67,35 @@ public:
 	
 	history hist{};
 	counter_list counter{};
-	std::array<key64, 256> rep_hash{};
+	std::vector<key64> rep_hash{};
 	bool use_syzygy{};
 
 	// keeping track of the principal variation, node count, table-base hits and selective depth
 
 	std::vector<move_var> pv;
+	std::array<move_line, lim::dt * 2> pv_table{};
 	int64 cnt_n{};
 	int64 cnt_tbhit{};
 	int   cnt_root_mv{};
 	depth seldt{};
 
-	// using king-pawn hash table to speed up the evaluation
+	// using hash tables to speed up the evaluation
+	// and an accumulator for every ply if the evaluation is done by the neural network
 
-	kingpawn_hash hash{ kingpawn_hash::ALLOCATE };
+	eval_hash hash{ eval_hash::ALLOCATE };
+	std::vector<nnue::accumulator> acc{};
+
+	// keeping the outcome of the previous search to warm-start the next analysis
+	// of the same position or of a position further down the principal variation, reached through the same game
+
+	struct prior_search
+	{
+		board pos{};
+		std::vector<key64> game_hash{};
+		depth dt{};
+		std::vector<move_var> pv{};
+		std::vector<rootsort::root_node> root{};
+	} prior{};
 
 private:
 	void idle();
@@ -115,6 +132,7 @@ public:
 	int64 get_tbhits() const;
 
 	std::tuple<score, bound> probe_syzygy(board& pos, depth dt, depth stack_dt);
+	std::tuple<score, bound> probe_bitbase(const board& pos, depth stack_dt) const;
 	void extend_time(score drop);
 	void rearrange_pv();
 };
@@ -145,5 +163,8 @@ public:
 	bool join_main();
 	void start_clock(const timemanage::move_time &movetime);
 	void clear_history();
+	void clear_prior();
+	void allocate_eval_hash();
 	std::tuple<move, move> get_bestmove() const;
+	double get_pawn_hitrate() const;
 };
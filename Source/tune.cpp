@@ -119,14 +119,13 @@ namespace tune
 
 			// quiescence-search resolves non-quiet positions
 			
-			search::node::p_variation pv{};
-			search::node nd{ &curr_pos.pos, &pv, false, false, false };
-			nd.p_var->cnt = 0;
+			search::node nd{ &curr_pos.pos, false, false, false };
 			nd.check = curr_pos.pos.check();
 			auto stack{ threads.thread[0]->stack_front() };
 			stack->cont_mv = &threads.thread[0]->hist.corr_cont[PAWN][H1];
 
 			search::qsearch(*threads.thread[0], stack + 1, nd, 0, -MATE, MATE);
+			const move_line& pv{ threads.thread[0]->pv_table[(stack + 1)->dt] };
 			for (depth dt{}; dt < std::min(pv.cnt, lim::dt); ++dt)
 				curr_pos.pos.new_move(pv.mv[dt]);
 
@@ -331,7 +330,7 @@ namespace tune
 
 		verify(range_min < range_max);
 
-		kingpawn_hash hash(kingpawn_hash::ALLOCATE_NONE);
+		eval_hash hash(eval_hash::ALLOCATE_PRIVATE);
 		double err_range{};
 
 		for (int i{ range_min }; i < range_max; ++i)
@@ -183,9 +183,15 @@ namespace lim
 	constexpr milliseconds overhead{ 5000 };
 
 	constexpr std::size_t hash{ 262144 };
+	constexpr std::size_t pawn_hash{ 98304 };
 	constexpr std::size_t moves{ 218 };
 	constexpr std::size_t multipv{ moves };
 
+	// the number of tried quiet moves & captures remembered per ply for the history malus
+
+	constexpr int tried_quiets{ 64 };
+	constexpr int tried_captures{ 32 };
+
 	constexpr depth dt{ 110 };
 	constexpr depth dtz{ 1048 };
 
@@ -30,10 +30,13 @@
 #include "trans.h"
 #include "thread.h"
 #include "syzygy.h"
+#include "bitbase.h"
 #include "search.h"
 #include "tune.h"
 #include "eval.h"
+#include "nnue.h"
 #include "misc.h"
+#include "magic.h"
 #include "time.h"
 #include "bench.h"
 #include "movegen.h"
@@ -42,6 +45,11 @@
 
 namespace
 {
+	// keeping track of the last 'position' command to handle appended moves incrementally
+
+	std::string game_fen{};
+	std::vector<std::string> game_mv{};
+
 	bool boolean(const std::string& value)
 	{
 		// converting string to bool
@@ -118,13 +126,16 @@ namespace
 		return move{};
 	}
 
-	void reset_game()
+	void reset_game(const board& pos)
 	{
 		// resetting all game-specific parameters used to detect repetitions
+		// the game starts anew from the current position, which is always the last entry of the game history
 
 		uci::mv_cnt = 0;
 		uci::mv_offset = 0;
-		for (auto& hash : uci::game_hash) hash = 0ULL;
+		uci::game_hash = { pos.key.pos };
+		game_fen.clear();
+		game_mv.clear();
 	}
 
 	void save_move(const board& pos)
@@ -135,17 +146,19 @@ namespace
 		uci::mv_offset = pos.half_cnt ? uci::mv_offset + 1 : 0;
 		verify(uci::mv_offset <= pos.half_cnt);
 
-		uci::game_hash[uci::mv_offset] = pos.key.pos;
+		// positions before an irreversible move can't be repeated anymore and are discarded
+
+		uci::game_hash.resize(uci::mv_offset);
+		uci::game_hash.push_back(pos.key.pos);
 	}
 
 	void set_position(board& pos, std::string fen)
 	{
 		// setting up a new position
 
-		reset_game();
 		pos.parse_fen(fen);
-		verify(uci::mv_offset == 0);
-		uci::game_hash[uci::mv_offset] = pos.key.pos;
+		reset_game(pos);
+		game_fen = fen;
 	}
 
 	void new_move(board& pos, move mv)
@@ -159,17 +172,20 @@ namespace
 
 namespace debug
 {
-	static void bench(std::istringstream& input)
+	static void bench(std::istringstream& input, const board& pos)
 	{
 		// running a benchmark search
+		// the benchmark replaces the game history, so the game starts anew from the current position afterwards
 
 		milliseconds movetime{};
 		std::string filename{};
 		input >> filename;
 		input >> movetime;
-		reset_game();
+		reset_game(pos);
 		uci::hash_table.clear();
+		bitbase::wait();
 		bench::search(filename, movetime);
+		reset_game(pos);
 	}
 
 	static void perft(std::istringstream& input, board& pos)
@@ -187,19 +203,70 @@ namespace debug
 			bench::perft<mode::LEGAL>(pos, dt);
 	}
 
+	static void pick(std::istringstream& input)
+	{
+		// running a benchmark of the move-picker
+
+		int iterations{};
+		if (!(input >> iterations))
+			iterations = 10000;
+		bench::pick(iterations);
+	}
+
+	static void evalspeed(std::istringstream& input)
+	{
+		// running a benchmark of the static evaluation
+
+		int iterations{};
+		if (!(input >> iterations))
+			iterations = 10000;
+		bench::eval(iterations);
+	}
+
+	static void sliderspeed(std::istringstream& input)
+	{
+		// running a benchmark of the slider attack generation
+
+		int iterations{};
+		if (!(input >> iterations))
+			iterations = 100000;
+		bench::sliders(iterations);
+	}
+
+	static void nnuespeed(std::istringstream& input)
+	{
+		// running a benchmark of the neural network evaluation
+
+		int iterations{};
+		if (!(input >> iterations))
+			iterations = 1000;
+		bench::nnue(iterations);
+	}
+
+	static void bitbasespeed(std::istringstream& input)
+	{
+		// running a benchmark & a cross-check of the built-in bitbases
+
+		int iterations{};
+		if (!(input >> iterations))
+			iterations = 1000;
+		bitbase::wait();
+		bench::bitbase(iterations);
+	}
+
 	static void eval(const board& pos)
 	{
 		// doing a static evaluation of the current position
 
-		kingpawn_hash hash(kingpawn_hash::ALLOCATE_NONE);
+		eval_hash hash(eval_hash::ALLOCATE_NONE);
 		std::cout << double(eval::static_eval(pos, hash)) / 100.0 << std::endl;
 	}
 
-	static void tune(std::istringstream& input)
+	static void tune(std::istringstream& input, const board& pos)
 	{
 		// running the internal tuner to tune the evaluation function
 
-		reset_game();
+		reset_game(pos);
 		uci::hash_table.clear();
 		uci::infinite = true;
 		uci::stop = false;
@@ -215,7 +282,7 @@ namespace debug
 
 		// running the internal benchmark search with the now tuned evaluation
 
-		bench(input);
+		bench(input, pos);
 	}
 
 	[[maybe_unused]] static void show_search_params()
@@ -257,6 +324,8 @@ namespace uci
 			<< "\noption name Ponder type check default " << boolean(ponder)
 			<< "\noption name Hash type spin default " << hash_size << " min 2 max " << lim::hash
 			<< "\noption name Clear Hash type button"
+			<< "\noption name Pawn Hash type spin default " << pawn_hash_size << " min 3 max " << lim::pawn_hash
+			<< "\noption name Pawn Hash Shared type check default " << boolean(pawn_hash_shared)
 
 			<< "\noption name UCI_Chess960 type check default " << boolean(chess960)
 			<< "\noption name MultiPV type spin default " << multipv << " min 1 max " << lim::multipv
@@ -265,6 +334,7 @@ namespace uci
 
 			<< "\noption name SyzygyPath type string default " << syzygy_path
 			<< "\noption name SyzygyProbeDepth type spin default " << syzygy_dt << " min 1 max " << lim::dt
+			<< "\noption name EvalFile type string default " << eval_file
 			<< std::endl;
 	}
 
@@ -275,6 +345,7 @@ namespace uci
 
 		hash_table.clear();
 		threads.clear_history();
+		threads.clear_prior();
 		set_position(pos, startpos);
 	}
 
@@ -297,10 +368,21 @@ namespace uci
 		if (name == "Hash")
 		{
 			hash_size = hash_table.create(std::max(std::stoi(value), 2));
+			threads.clear_prior();
 		}
 		else if (name == "Clear Hash")
 		{
 			hash_table.clear();
+			threads.clear_prior();
+		}
+		else if (name == "Pawn Hash" || name == "Pawn Hash Shared")
+		{
+			if (name == "Pawn Hash")
+				pawn_hash_size = std::size_t(std::clamp(std::stoi(value), 3, int(lim::pawn_hash)));
+			else
+				pawn_hash_shared = boolean(value);
+			pawn_hash_size = eval_hash::create(pawn_hash_size, pawn_hash_shared);
+			threads.allocate_eval_hash();
 		}
 		else if (name == "Threads")
 		{
@@ -340,6 +422,22 @@ namespace uci
 		{
 			syzygy_dt = std::clamp(std::stoi(value), 1, lim::dt);
 		}
+		else if (name == "EvalFile")
+		{
+			// switching to the neural network evaluation, '<empty>' switches back to the hand-crafted evaluation
+
+			eval_file = value;
+			if (eval_file == "<empty>")
+				nnue::unload();
+			else if (nnue::load(eval_file))
+				std::cout << "info string loaded network " << eval_file
+					<< " with " << nnue::kernel_name[int(nnue::best_kernel)] << " inference" << std::endl;
+			else
+			{
+				std::cout << "info string warning: loading network failed: " << eval_file << std::endl;
+				eval_file = "<empty>";
+			}
+		}
 		else
 		{
 			// setting the search parameters during SPSA tuning
@@ -375,14 +473,26 @@ namespace uci
 				fen += token + " ";
 		}
 
-		set_position(pos, fen);
-		if (token != "moves")
-			return;
+		std::vector<std::string> moves{};
+		if (token == "moves")
+			while (input >> token)
+				moves.push_back(token);
 
-		// executing the move sequence
+		// continuing from the current position if the new move sequence only appends moves to the previous one
+		// otherwise setting up the position from scratch
 
-		while (input >> token)
-			new_move(pos, convert_mv(pos, token));
+		if (fen != game_fen
+			|| moves.size() < game_mv.size()
+			|| !std::equal(game_mv.begin(), game_mv.end(), moves.begin()))
+			set_position(pos, fen);
+
+		// executing the remaining move sequence
+
+		for (auto mv{ moves.begin() + game_mv.size() }; mv != moves.end(); ++mv)
+		{
+			new_move(pos, convert_mv(pos, *mv));
+			game_mv.push_back(*mv);
+		}
 	}
 
 	static void searchmoves(std::istringstream& input, const board& pos)
@@ -477,8 +587,10 @@ namespace uci
 		}
 
 		// starting the search for the best move
+		// the search probes the bitbases, so their generation has to be finished
 
 		stop = false;
+		bitbase::wait();
 		threads.thread[0]->std_thread = std::jthread{ search::start, std::ref(threads), chrono.get_movetime(pos.cl) };
 	}
 }
@@ -504,10 +616,12 @@ void uci::loop()
 		{
 			uci::uci();
 			debug::show_search_params();
+			std::cout << "info string slider attacks through " << magic::lookup_name[int(magic::mode)] << " lookups" << std::endl;
 			std::cout << "uciok" << std::endl;
 		}
 		else if (command == "isready")
 		{
+			bitbase::wait();
 			std::cout << "readyok" << std::endl;
 		}
 		else if (command == "ucinewgame")
@@ -551,7 +665,7 @@ void uci::loop()
 			// 'bench' or 'bench [positions.epd] [time in ms]'
 
 			if (!stop) continue;
-			debug::bench(input);
+			debug::bench(input, pos);
 		}
 		else if (token == "perft")
 		{
@@ -561,6 +675,46 @@ void uci::loop()
 			if (!stop) continue;
 			debug::perft(input, pos);
 		}
+		else if (token == "pick")
+		{
+			// running a benchmark of generating, weighting & picking moves
+			// 'pick [iterations]'
+
+			if (!stop) continue;
+			debug::pick(input);
+		}
+		else if (token == "evalspeed")
+		{
+			// running a benchmark of the static evaluation
+			// 'evalspeed [iterations]'
+
+			if (!stop) continue;
+			debug::evalspeed(input);
+		}
+		else if (token == "sliderspeed")
+		{
+			// running a benchmark of the batched slider attack generation
+			// 'sliderspeed [iterations]'
+
+			if (!stop) continue;
+			debug::sliderspeed(input);
+		}
+		else if (token == "nnuespeed")
+		{
+			// running a benchmark & an equivalence test of the neural network evaluation
+			// 'nnuespeed [iterations]'
+
+			if (!stop) continue;
+			debug::nnuespeed(input);
+		}
+		else if (token == "bitbasespeed")
+		{
+			// running a benchmark & a cross-check of the built-in bitbases
+			// 'bitbasespeed [iterations]'
+
+			if (!stop) continue;
+			debug::bitbasespeed(input);
+		}
 		else if (command == "eval")
 		{
 			// showing the static evaluation of the current position
@@ -580,7 +734,7 @@ void uci::loop()
 			// tuning evaluation parameters if the TUNE compiler-switch is on
 			// 'tune [positions.epd] [number of threads]'
 
-			debug::tune(input);
+			debug::tune(input, pos);
 		}
 	} while (command != "quit");
 }
@@ -57,10 +57,12 @@ namespace uci
 	inline int thread_cnt{ 1 };
 	inline int mv_cnt{};
 	inline int mv_offset{};
-	inline std::array<key64, 256> game_hash{};
+	inline std::vector<key64> game_hash{};
 
 	inline std::size_t multipv{ 1 };
 	inline std::size_t hash_size{ 128 };
+	inline std::size_t pawn_hash_size{ 96 };
+	inline bool pawn_hash_shared{ false };
 	inline milliseconds overhead{};
 
 	inline struct search_limit
@@ -75,6 +77,7 @@ namespace uci
 
 	inline std::string syzygy_path{ "<empty>" };
 	inline depth syzygy_dt{ 5 };
+	inline std::string eval_file{ "<empty>" };
 
 	// main transposition hash-table
 
@@ -17,6 +17,7 @@
 
 
 #include <type_traits>
+#include <utility>
 #include <bit>
 
 #include "main.h"
@@ -27,15 +28,49 @@
 #include "move.h"
 #include "zobrist.h"
 
-void zobrist::init_keys()
+void zobrist::init_cuckoo()
 {
-	// generating Zobrist hash keys
+	// filling the cuckoo tables with the keys of all reversible piece moves on an empty board
 
-	rand_64 rand_gen{};
-	for (auto&  cl : key_pc)     for (auto& pc  : cl) for (auto& key : pc) key = rand_gen.rand64();
-	for (auto&  cl : key_castle) for (auto& key : cl) key = rand_gen.rand64();
-	for (auto& key : key_ep)     key = rand_gen.rand64();
-	key_cl = rand_gen.rand64();
+	[[maybe_unused]] int cnt{};
+	for (color cl : { WHITE, BLACK })
+		for (piece pc : { KNIGHT, BISHOP, ROOK, QUEEN, KING })
+			for (square sq1{ H1 }; sq1 <= A8; sq1 += 1)
+				for (square sq2{ sq1 + 1 }; sq2 <= A8; sq2 += 1)
+				{
+					if (!(bit::pc_attack[pc][sq1] & bit::set(sq2)))
+						continue;
+
+					// inserting the move, displacing colliding entries to their alternative slot
+
+					move  mv{ sq1, sq2, pc, NO_PIECE, cl, NO_FLAG };
+					key64 key{ key_pc[cl][pc][sq1] ^ key_pc[cl][pc][sq2] ^ key_cl };
+					int idx{ cuckoo_h1(key) };
+					while (true)
+					{
+						std::swap(cuckoo_key[idx], key);
+						std::swap(cuckoo_mv[idx], mv);
+						if (!mv)
+							break;
+						idx = idx == cuckoo_h1(key) ? cuckoo_h2(key) : cuckoo_h1(key);
+					}
+					cnt += 1;
+				}
+	verify(cnt == 3668);
+}
+
+int zobrist::cuckoo_h1(key64 key)
+{
+	// first hash function indexing the cuckoo tables
+
+	return int(key & (cuckoo_size - 1));
+}
+
+int zobrist::cuckoo_h2(key64 key)
+{
+	// second hash function indexing the cuckoo tables
+
+	return int((key >> 16) & (cuckoo_size - 1));
 }
 
 key64 zobrist::pos_key(const board &pos)
@@ -80,24 +115,49 @@ key64 zobrist::pos_key(const board &pos)
 	return key;
 }
 
-key64 zobrist::pos_key(const board& pos, move& new_mv)
+namespace
 {
-	// generating a new hash key simulating the state as if the move had been made
-	// en-passant and changes to castling rights are not considered
+	void toggle_piece(board::key_pos& key, color cl, piece pc, square sq, bool capture)
+	{
+		// adding or removing a piece from the hash keys the same way as the incremental update of the board does
+
+		key64 pc_key{ zobrist::key_pc[cl][pc][sq] };
+		key.pos ^= pc_key;
+		if (pc == PAWN)
+			key.pawn ^= pc_key;
+		if (pc != PAWN || capture)
+			key.nonpawn[cl] ^= pc_key;
+		if (pc == KNIGHT || pc == BISHOP || (pc == KING && !capture))
+			key.minor ^= pc_key;
+		else if (pc == ROOK || pc == QUEEN)
+			key.major ^= pc_key;
+	}
+}
+
+board::key_pos zobrist::next_keys(const board& pos, move new_mv)
+{
+	// generating the hash keys simulating the state as if the move had been made, used to prefetch table entries
+	// en-passant, changes to castling rights, the rook of castling moves & the material key are not considered
 
-	key64 key{ pos.key.pos };
+	board::key_pos key{ pos.key };
 	move::item mv{ new_mv };
 
-	// considering the moving piece
+	if (new_mv)
+	{
+		// considering the moving piece
+
+		toggle_piece(key, mv.cl, mv.pc, mv.sq1, false);
+		toggle_piece(key, mv.cl, mv.promo() ? mv.promo_pc() : mv.pc, mv.sq2, false);
 
-	key ^= key_pc[mv.cl][mv.pc][mv.sq1];
-	key ^= key_pc[mv.cl][mv.promo() ? mv.promo_pc() : mv.pc][mv.sq2];
+		// considering the captured piece
 
-	// considering the captured piece
+		if (mv.vc != NO_PIECE)
+			toggle_piece(key, mv.cl ^ 1, mv.vc, mv.sq2, true);
+	}
 
-	if (mv.vc != NO_PIECE)
-		key ^= key_pc[mv.cl ^ 1][mv.vc][mv.sq2];
+	// considering side to move
 
+	key.pos ^= key_cl;
 	return key;
 }
 
@@ -136,11 +196,13 @@ key64 zobrist::nonpawn_key(const board& pos, color cl)
 	return key;
 }
 
-key64 zobrist::kingpawn_key(const board& pos)
+key64 zobrist::shelter_key(const board& pos)
 {
-	// adding the king position to the pawn hash key to index the king-pawn evaluation table
+	// adding the king files to the pawn hash key to index the king-shelter evaluation table
+	// the keys of the kings on the first rank are used, because the shelter doesn't depend on the king ranks
 
-	return pos.key.pawn ^ key_pc[WHITE][KING][pos.sq_king[WHITE]] ^ key_pc[BLACK][KING][pos.sq_king[BLACK]];
+	return pos.key.pawn ^ key_pc[WHITE][KING][type::sq_of(RANK_1, type::fl_of(pos.sq_king[WHITE]))]
+	                    ^ key_pc[BLACK][KING][type::sq_of(RANK_1, type::fl_of(pos.sq_king[BLACK]))];
 }
 
 key64 zobrist::minor_key(const board& pos)
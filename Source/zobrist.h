@@ -20,6 +20,7 @@
 
 #include <array>
 
+#include "misc.h"
 #include "move.h"
 #include "board.h"
 #include "types.h"
@@ -31,26 +32,59 @@
 namespace zobrist
 {
 	// to make a position unique: piece placement, castling rights, en-passant and side to move
+	// the keys are generated at compile time & stored read-only in the binary
 
-	inline std::array<std::array<std::array<key64, 64>, 6>, 2>
-		key_pc;
-	inline std::array<std::array<key64, 2>, 2>
-		key_castle;
-	inline std::array<key64, 8>
-		key_ep;
-	inline key64
-		key_cl;
+	struct key_table
+	{
+		std::array<std::array<std::array<key64, 64>, 6>, 2> pc;
+		std::array<std::array<key64, 2>, 2> castle;
+		std::array<key64, 8> ep;
+		key64 cl;
+	};
+
+	constexpr key_table init_keys()
+	{
+		// generating Zobrist hash keys
+
+		key_table keys{};
+		rand_64xor rand_gen{ 0x9e3779b97f4a7c15ULL };
+		for (auto&  cl : keys.pc)     for (auto& pc  : cl) for (auto& key : pc) key = rand_gen.rand64();
+		for (auto&  cl : keys.castle) for (auto& key : cl) key = rand_gen.rand64();
+		for (auto& key : keys.ep)     key = rand_gen.rand64();
+		keys.cl = rand_gen.rand64();
+		return keys;
+	}
+
+	inline constexpr key_table keys{ init_keys() };
+
+	inline constexpr auto& key_pc    { keys.pc };
+	inline constexpr auto& key_castle{ keys.castle };
+	inline constexpr auto& key_ep    { keys.ep };
+	inline constexpr auto& key_cl    { keys.cl };
+
+	// cuckoo tables of all reversible piece moves, used to detect upcoming repetitions
+	// the technique is from Marcel van Kervinck:
+	// http://web.archive.org/web/20201107002606/https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
+
+	constexpr int cuckoo_size{ 8192 };
+	inline std::array<key64, cuckoo_size>
+		cuckoo_key;
+	inline std::array<move, cuckoo_size>
+		cuckoo_mv;
+
+	int cuckoo_h1(key64 key);
+	int cuckoo_h2(key64 key);
 
 	// creating hash keys
 
-	void init_keys();
+	void init_cuckoo();
 	
 	key64 pos_key(const board& pos);
-	key64 pos_key(const board& pos, move& mv);
+	board::key_pos next_keys(const board& pos, move mv);
 	key64 adjust_key(const key64& key, move& mv);
 	key64 pawn_key(const board& pos);
 	key64 nonpawn_key(const board& pos, color cl);
-	key64 kingpawn_key(const board& pos);
+	key64 shelter_key(const board& pos);
 	key64 minor_key(const board& pos);
 	key64 major_key(const board& pos);
 